@@ -0,0 +1,60 @@
+//////////////////////////////////////////////////////////////////////////////
+// Fuzzer entry point
+//
+// Runs the checks of the encoder verifier on each input of libFuzzer. The
+// file is built with the sources of the library instead of main.cpp, e.g.
+// with clang and -fsanitize=fuzzer,address,undefined. The input is encoded
+// with a key generated for it and with the delta filter, decoded as if it
+// were an encoding, and also used as a key, which is mostly not valid.
+// Its context statistics are compared with exact counts.
+// A failed check aborts, such that the fuzzer keeps the input.
+//////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include "include/ByteStream.h"
+#include "include/DeltaFilter.h"
+#include "include/EncoderVerifier.h"
+#include "include/SeekIndex.h"
+#include "include/SimpleCompression.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size)
+{
+	const ByteView input{ reinterpret_cast<const char*>(data), size };
+	EncoderVerifier verifier;
+
+	ByteStream in_stream;
+	ByteStream out_stream;
+	ByteStream key_stream;
+	in_stream.append(input.data, input.size);
+	in_stream.bytes_changed();
+
+	// Round trip with a key generated for the input, and the input decoded with that key
+	SimpleCompression compression(in_stream, out_stream, key_stream);
+	if (input.size > 0 && compression.GenerateKey())
+	{
+		SeekIndex index;
+		compression.SetSeekIndex(&index);
+		verifier.CheckRoundTrip(compression, input);
+		verifier.CheckCodec(key_stream, input);
+		verifier.CheckDecode(key_stream, input);
+	}
+
+	// The input as a key
+	verifier.CheckDecode(in_stream, input);
+
+	DeltaFilter filter(in_stream, out_stream, key_stream);
+	verifier.CheckRoundTrip(filter, input);
+
+	verifier.CheckStatistics(input);
+
+	if (!verifier.Failures().empty())
+	{
+		for (auto i = verifier.Failures().cbegin(); i != verifier.Failures().cend(); i++)
+			std::cerr << "Check failed: " << *i << "\n";
+		std::abort();
+	}
+
+	return 0;
+}
@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////////////
+// Byte sink classes
+//
+// Destinations for encoded/decoded bytes. Encoders reserve room at the end
+// of a sink, write directly into it, and commit the number of bytes that
+// were actually written. Sinks are provided for growable vectors, fixed
+// caller-supplied buffers and byte streams.
+//////////////////////////////////////////////////////////////////////////////
+#ifndef HEADER_BYTESINK
+#define HEADER_BYTESINK
+
+#include <cstddef>
+#include <vector>
+
+#include "ByteStream.h"
+
+class ByteSink
+{
+	public:
+		// Constructor / destructor
+		ByteSink();
+		virtual ~ByteSink();
+
+		// Returns a buffer for upto 'size' bytes at the end of the sink, or nullptr if there is not enough room
+		virtual char* reserve(std::size_t size) = 0;
+
+		// Keeps the first 'size' bytes of the buffer returned by the last call to reserve
+		virtual void commit(std::size_t size) = 0;
+
+		// Returns the number of bytes which can still be reserved
+		virtual std::size_t room() const;
+
+		// Returns the number of bytes committed since the sink was constructed
+		virtual std::size_t written() const = 0;
+};
+
+// Appends to a vector
+class VectorSink : public ByteSink
+{
+	private:
+		std::vector<char>& _vector;
+		std::size_t _initial;		// Size of the vector when the sink was constructed
+		std::size_t _reserved;		// Size of the vector before the last reservation
+
+	public:
+		VectorSink(std::vector<char>& vector);
+		~VectorSink();
+
+		char* reserve(std::size_t size) override;
+		void commit(std::size_t size) override;
+		std::size_t written() const override;
+};
+
+// Writes to a fixed buffer
+class SpanSink : public ByteSink
+{
+	private:
+		char* _data;
+		std::size_t _capacity;
+		std::size_t _size;
+
+	public:
+		SpanSink(char* data, std::size_t capacity);
+		~SpanSink();
+
+		char* reserve(std::size_t size) override;
+		void commit(std::size_t size) override;
+		std::size_t room() const override;
+		std::size_t written() const override;
+};
+
+// Appends to a byte stream
+class ByteStreamSink : public ByteSink
+{
+	private:
+		ByteStream& _stream;
+		std::size_t _initial;		// Size of the stream when the sink was constructed
+		std::size_t _reserved;		// Size of the stream before the last reservation
+
+	public:
+		ByteStreamSink(ByteStream& stream);
+		~ByteStreamSink();
+
+		char* reserve(std::size_t size) override;
+		void commit(std::size_t size) override;
+		std::size_t written() const override;
+};
+
+#endif
@@ -12,18 +12,30 @@
 
 using bitstream_index = long long;
 
+// Number of bits of the order-2 context: the preceding byte, followed by a hash of the byte before it in the remaining bits
+const unsigned int order2_context_bits = 10;
+
 class ByteStream
 {
 	private:
 		// Data members
 		std::vector<char> _data;
 		unsigned short _nextBit;
-		unsigned int _byteFrequency[256];
+		unsigned long long _byteFrequency[256];
 		double _byteProbability[256];
 		bool _bytesChanged;		// Dirty flag
+		unsigned long long _setBits;	// Number of bits set to one in the stream
+
+		// Context statistics (only gathered if the context order is above zero)
+		unsigned short _contextOrder;
+		std::vector<unsigned long long> _order1Frequency;		// Indexed by (previous byte << 8) | byte
+		std::vector<unsigned long long> _order2Frequency;		// Indexed by (previous byte, hashed byte before it) << 8 | byte
 
 		// Private methods
 		void BytesChanged();
+		void GatherStatistics();
+		static void CountBytes(const char* data, std::size_t first, std::size_t last, unsigned short order, unsigned long long* histogram);
+		static double ConditionalEntropy(const std::vector<unsigned long long>& frequency, std::size_t total);
 
 	public:
 		// Constructor / destructor
@@ -32,8 +44,8 @@ class ByteStream
 		~ByteStream();
 
 		// Operator overloads
-		char& operator[](unsigned int index);					// Indexing
-		const char operator[](unsigned int index) const;		// Const version
+		char& operator[](std::size_t index);					// Indexing
+		const char operator[](std::size_t index) const;			// Const version
 		const ByteStream& operator=(const ByteStream& stream);	// Copy-assignment
 
 		// Iterators
@@ -45,12 +57,17 @@ class ByteStream
 		// Analysis methods
 		double byte_entropy() const;
 		double bit_entropy() const;
-		unsigned int byte_frequency(int byte) const;
+		unsigned long long byte_frequency(int byte) const;
 		double byte_probability(int byte) const;
 		double byte_information_content(int byte) const;
+		double conditional_entropy(unsigned short order) const;
+		unsigned short context_order() const;
+		void set_context_order(unsigned short order);
 
 		// Bit manipulation methods
 		void put(char datum, unsigned short bits = 8);
+		void append(const char* bytes, std::size_t count);
+		void resize(std::size_t size);
 		char read(bitstream_index firstBit, unsigned short bits = 8) const;
 		void clear();
 
@@ -58,7 +75,9 @@ class ByteStream
 		void bytes_changed(bool forceImmediateUpdate = true);
 		bool load(const std::string& filename);
 		bool save(const std::string& filename);
-		unsigned int size() const;
+		std::size_t size() const;
+		const char* data() const;
+		char* data();
 };
 
 #endif
\ No newline at end of file
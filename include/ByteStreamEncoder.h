@@ -7,30 +7,38 @@
 #ifndef HEADER_BYTESTREAM_ENCODER
 #define HEADER_BYTESTREAM_ENCODER
 
+#include "ByteSink.h"
 #include "ByteStream.h"
+#include "ByteView.h"
+#include "EncoderMetrics.h"
 
 class ByteStreamEncoder
 {
 	protected:
-		// Data members
-		const ByteStream& _inStream;
-		ByteStream& _outStream;
-		ByteStream& _keyStream;
+		// Data members (pointers, such that the key stream can be replaced)
+		const ByteStream* _inStream;
+		ByteStream* _outStream;
+		ByteStream* _keyStream;
+		EncoderMetrics _metrics;
 
 	public:
 		// Constructor / destructor
 		ByteStreamEncoder(const ByteStream& inStream, ByteStream& outStream, ByteStream& keyStream);
 		virtual ~ByteStreamEncoder();
 
-		// Public interface
-		virtual bool Encode() = 0;
-		virtual bool Decode() = 0;
+		// Public interface (coding the input stream into the output stream, or a view into a sink)
+		virtual bool Encode();
+		virtual bool Decode();
+		virtual bool Encode(ByteView input, ByteSink& output) = 0;
+		virtual bool Decode(ByteView input, ByteSink& output) = 0;
 		virtual bool UsesKey() const = 0;
 		virtual std::string Name() const = 0;
 		virtual bool GenerateKey();
 
 		// Other public methods
 		void SetKeyStream(ByteStream& keyStream);
+		const EncoderMetrics& Metrics() const;
+		void ResetMetrics();
 };
 
 #endif
\ No newline at end of file
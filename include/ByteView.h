@@ -0,0 +1,18 @@
+//////////////////////////////////////////////////////////////////////////////
+// Byte view
+//
+// Non-owning view of a contiguous range of bytes, e.g. a message in a
+// network buffer or a part of a byte stream.
+//////////////////////////////////////////////////////////////////////////////
+#ifndef HEADER_BYTEVIEW
+#define HEADER_BYTEVIEW
+
+#include <cstddef>
+
+struct ByteView
+{
+	const char* data;
+	std::size_t size;
+};
+
+#endif
@@ -0,0 +1,68 @@
+//////////////////////////////////////////////////////////////////////////////
+// Codec cache class
+//
+// Compiled codecs of the most recently used keys, looked up by key id, such
+// that a key used for many messages is only parsed once. The key bytes are
+// kept with each codec, so a key whose id is that of another cached key
+// is compiled rather than given the other key's codec. When the cache is
+// full, the least recently used codec is dropped (encoders still holding
+// it keep it alive). The cache may be shared by several threads.
+//////////////////////////////////////////////////////////////////////////////
+#ifndef HEADER_CODEC_CACHE
+#define HEADER_CODEC_CACHE
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ByteStream.h"
+#include "SimpleCodec.h"
+
+class CodecCache
+{
+	// A compiled codec and the key it was compiled from
+	struct cache_entry
+	{
+		std::vector<char> key;
+		std::shared_ptr<const SimpleCodec> codec;
+	};
+	using codec_list = std::list<cache_entry>;
+
+	private:
+		// Data members
+		std::size_t _capacity;
+		codec_list _codecs;											// Most recently used first
+		std::unordered_map<unsigned int, codec_list::iterator> _ids;	// Position of each key id in the list
+		unsigned long long _hits;
+		unsigned long long _misses;
+		mutable std::mutex _mutex;
+
+		// Private methods
+		void Touch(codec_list::iterator codec);
+
+	public:
+		// Constructor / destructor
+		CodecCache(std::size_t capacity = 16);
+		~CodecCache();
+
+		// Returns the codec of a key, compiling the key if it is not cached. Returns an empty pointer if the key is not valid.
+		std::shared_ptr<const SimpleCodec> Get(const ByteStream& keyStream);
+
+		// Returns the codec of the cached key with an id, or an empty pointer if there is none
+		std::shared_ptr<const SimpleCodec> Find(unsigned int keyId);
+
+		// Adds the compiled codec of a key, e.g. of a pretrained key, replacing a cached key with the same id
+		void Add(const ByteStream& keyStream, std::shared_ptr<const SimpleCodec> codec);
+
+		// Access methods
+		void clear();
+		std::size_t size() const;
+		std::size_t capacity() const;
+		unsigned long long hits() const;
+		unsigned long long misses() const;
+};
+
+#endif
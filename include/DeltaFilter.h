@@ -0,0 +1,65 @@
+//////////////////////////////////////////////////////////////////////////////
+// Delta filter class
+//
+// Pre-filter for arrays of numbers, to be applied before an entropy coder.
+// Each 8, 16, 32 or 64 bit word is replaced by its difference from (or its
+// XOR with) the previous word, so slowly changing values become mostly
+// small numbers and zero bytes. Words are taken in the byte order of the
+// machine, i.e. little-endian on the targeted platforms. The filter and
+// word size are written in the first byte of the output, such that
+// decoding inverts the filter exactly without further information.
+//////////////////////////////////////////////////////////////////////////////
+#ifndef HEADER_DELTA_FILTER
+#define HEADER_DELTA_FILTER
+
+#include "ByteStreamEncoder.h"
+
+class DeltaFilter : public ByteStreamEncoder
+{
+	public:
+		// Operation applied to consecutive words
+		enum class Mode : unsigned char
+		{
+			None,		// Bytes are copied
+			Delta,		// Difference from the previous word
+			Xor			// XOR with the previous word
+		};
+
+		// Number of bytes of the input used to choose the filter
+		static const std::size_t sample_size = 1 << 16;
+
+	private:
+		// Data members
+		Mode _mode;
+		unsigned int _stride;		// Bytes per word, or zero to choose the filter from the input
+
+		// Private methods
+		static bool ValidStride(unsigned int stride);
+		template <typename Word> static void DeltaWords(const char* input, char* output, std::size_t words);
+		template <typename Word> static void UndeltaWords(const char* input, char* output, std::size_t words);
+
+	public:
+		// Constructor / destructor
+		DeltaFilter(const ByteStream& inStream, ByteStream& outStream, ByteStream& keyStream);
+		~DeltaFilter();
+
+		// Public ByteStreamEncoder interface
+		using ByteStreamEncoder::Encode;
+		using ByteStreamEncoder::Decode;
+		bool Encode(ByteView input, ByteSink& output) override;
+		bool Decode(ByteView input, ByteSink& output) override;
+		bool UsesKey() const override;
+		std::string Name() const override;
+
+		// Sets the filter and word size (1, 2, 4 or 8 bytes), or a stride of zero to choose both from the input when encoding
+		void SetFilter(Mode mode, unsigned int stride);
+
+		// Chooses the filter and word size giving the lowest byte entropy of (a sample of) the filtered input
+		static void ChooseFilter(ByteView input, Mode& mode, unsigned int& stride);
+
+		// Filters the input into an output buffer of the same size, or inverts the filter
+		static void Filter(Mode mode, unsigned int stride, ByteView input, char* output);
+		static void Unfilter(Mode mode, unsigned int stride, ByteView input, char* output);
+};
+
+#endif
@@ -0,0 +1,95 @@
+//////////////////////////////////////////////////////////////////////////////
+// Encoder metrics class
+//
+// Collects timing and throughput figures for the phases of an encoder
+// (key building, encoding/decoding loop, statistics update), and exports
+// them as JSON. Collection is compiled out if BYTESTREAM_DISABLE_METRICS
+// is defined.
+//////////////////////////////////////////////////////////////////////////////
+#ifndef HEADER_ENCODER_METRICS
+#define HEADER_ENCODER_METRICS
+
+#include <chrono>
+#include <map>
+#include <string>
+
+// Phases of an encoder which are timed
+enum class EncoderPhase
+{
+	KeyBuild,
+	EncodeLoop,
+	DecodeLoop,
+	StatsUpdate,
+	Count
+};
+
+class EncoderMetrics
+{
+	private:
+		// Accumulated time spent in a phase
+		struct PhaseTiming
+		{
+			double wallSeconds;
+			double cpuSeconds;
+			unsigned long long calls;
+		};
+
+		// Data members
+		PhaseTiming _phases[static_cast<int>(EncoderPhase::Count)];
+		unsigned long long _bytesIn;
+		unsigned long long _bytesOut;
+		unsigned long long _symbols;
+		std::map<std::string, double> _values;		// Algorithm specific values, e.g. key properties
+
+	public:
+		// Constructor / destructor
+		EncoderMetrics();
+		~EncoderMetrics();
+
+		// Collection methods
+		void add_phase(EncoderPhase phase, double wallSeconds, double cpuSeconds);
+		void add_bytes(unsigned long long bytesIn, unsigned long long bytesOut);
+		void add_symbols(unsigned long long symbols);
+		void set_value(const std::string& name, double value);
+		void clear();
+
+		// Access methods
+		double wall_seconds(EncoderPhase phase) const;
+		double cpu_seconds(EncoderPhase phase) const;
+		unsigned long long bytes_in() const;
+		unsigned long long bytes_out() const;
+		unsigned long long symbols() const;
+		double symbols_per_second() const;
+		double value(const std::string& name) const;
+		std::string to_json() const;
+};
+
+// Adds the time until the end of the scope to a phase of the metrics
+class ScopedPhaseTimer
+{
+	private:
+		EncoderMetrics& _metrics;
+		EncoderPhase _phase;
+		std::chrono::steady_clock::time_point _wallStart;
+		double _cpuStart;
+
+		// CPU time used by the calling thread
+		static double ThreadCpuSeconds();
+
+	public:
+		ScopedPhaseTimer(EncoderMetrics& metrics, EncoderPhase phase);
+		~ScopedPhaseTimer();
+};
+
+// Hooks used by the encoders, which are removed entirely if metrics are disabled
+#ifndef BYTESTREAM_DISABLE_METRICS
+	#define ENCODER_METRICS_CONCAT_(a, b) a##b
+	#define ENCODER_METRICS_CONCAT(a, b) ENCODER_METRICS_CONCAT_(a, b)
+	#define ENCODER_METRICS_PHASE(metrics, phase) ScopedPhaseTimer ENCODER_METRICS_CONCAT(phase_timer_, __LINE__)(metrics, phase)
+	#define ENCODER_METRICS(statement) statement
+#else
+	#define ENCODER_METRICS_PHASE(metrics, phase)
+	#define ENCODER_METRICS(statement)
+#endif
+
+#endif
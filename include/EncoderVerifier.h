@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////////////
+// Encoder verifier class
+//
+// Round-trip and differential checks of the encoders. Inputs are encoded
+// and decoded again through the ByteStreamEncoder interface, and the
+// optimized SimpleCodec paths (specialized and generic loops, encoding in
+// parts, batches, ranges) are compared with a reference implementation
+// coding one codeword at a time with ByteStream::put() and read(), as the
+// algorithm was originally written. The checks take any input, so they
+// can also be driven by a fuzzer.
+//////////////////////////////////////////////////////////////////////////////
+#ifndef HEADER_ENCODER_VERIFIER
+#define HEADER_ENCODER_VERIFIER
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ByteStream.h"
+#include "ByteStreamEncoder.h"
+#include "ByteView.h"
+
+class EncoderVerifier
+{
+	// Size of the input of the large input check, beyond the sizes and bit offsets that fit in 32 bits
+	static const unsigned long long large_input_size = (1ULL << 32) + (1ULL << 29);
+
+	using reference_map = std::map<char, std::pair<unsigned int, int>>;		// Byte to codeword and its number of bits
+
+	private:
+		// Data members
+		std::mt19937 _random;
+		unsigned long long _checks;
+		std::vector<std::string> _failures;
+
+		// Private methods
+		bool Check(bool passed, const std::string& check, std::size_t size);
+		std::vector<std::vector<char>> GenerateInputs(int iterations);
+
+		// Reference implementation
+		static bool ReferenceKey(const ByteStream& keyStream, reference_map& map, int& bits_short, int& bits_long);
+		static bool ReferenceEncode(const reference_map& map, ByteView input, ByteStream& output);
+		static void ReferenceDecode(const reference_map& map, int bits_short, int bits_long, const ByteStream& input, std::vector<char>& output);
+		static double ReferenceConditionalEntropy(ByteView input, int order);
+
+	public:
+		// Constructor / destructor
+		EncoderVerifier(unsigned int seed = 1);
+		~EncoderVerifier();
+
+		// Encodes and decodes the input with an encoder (which must have a key if it uses one),
+		// and checks that the decoded bytes are the input
+		bool CheckRoundTrip(ByteStreamEncoder& encoder, ByteView input);
+
+		// Compares encoding and decoding of the input with a compiled key against the reference implementation
+		bool CheckCodec(const ByteStream& keyStream, ByteView input);
+
+		// Compares decoding of arbitrary bytes (which need not be a valid encoding) against the reference implementation
+		bool CheckDecode(const ByteStream& keyStream, ByteView input);
+
+		// Compares the conditional entropies of the input, from the statistics of a byte stream, with entropies from exact context counts
+		bool CheckStatistics(ByteView input);
+
+		// Runs all checks for all encoders on generated inputs: single and all 256 byte values,
+		// random alphabets and lengths (giving codewords of all lengths), slowly changing numbers,
+		// and random bytes to decode
+		bool Run(int iterations);
+
+		// Opt-in check of an input above 4 GiB, written as a sparse file of the given name, which is removed afterwards.
+		// Needs memory for the whole input.
+		bool CheckLargeInput(const std::string& filename, unsigned long long size = large_input_size);
+
+		// Results
+		unsigned long long Checks() const;
+		const std::vector<std::string>& Failures() const;
+};
+
+#endif
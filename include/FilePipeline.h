@@ -0,0 +1,65 @@
+//////////////////////////////////////////////////////////////////////////////
+// File pipeline class
+//
+// Encodes a file into another file in fixed size chunks. A reader thread
+// reads the next chunks and a writer thread writes the previous ones while
+// the calling thread encodes the current chunk, such that disk and CPU are
+// busy at the same time. The chunks are encoded as one continuous message,
+// so the output is identical to that of encoding the whole file at once.
+//////////////////////////////////////////////////////////////////////////////
+#ifndef HEADER_FILE_PIPELINE
+#define HEADER_FILE_PIPELINE
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "EncoderMetrics.h"
+#include "SimpleCodec.h"
+
+class FilePipeline
+{
+	// Queue of buffer indices passed between the pipeline stages
+	class BufferQueue
+	{
+		private:
+			std::deque<int> _buffers;
+			bool _closed;
+			std::mutex _mutex;
+			std::condition_variable _condition;
+
+		public:
+			BufferQueue();
+
+			void push(int buffer);
+			bool pop(int& buffer);		// Waits for a buffer, returns false if the queue is closed
+			void close();
+	};
+
+	// Number of buffers per stage (one being filled, one being processed and one being emptied)
+	static const int buffer_count = 3;
+
+	private:
+		// Data members
+		std::shared_ptr<const SimpleCodec> _codec;
+		std::size_t _chunkSize;
+		EncoderMetrics _metrics;
+
+	public:
+		// Constructor / destructor
+		FilePipeline(std::shared_ptr<const SimpleCodec> codec, std::size_t chunkSize = 1 << 20);
+		~FilePipeline();
+
+		// Encodes the input file into the output file (optionally building its seek index),
+		// returns false on read/write errors or if a byte of the input has no codeword
+		bool EncodeFile(const std::string& inFile, const std::string& outFile, SeekIndex* index = nullptr);
+
+		// Timing of the encoding and the number of bytes read and written
+		const EncoderMetrics& Metrics() const;
+		void ResetMetrics();
+};
+
+#endif
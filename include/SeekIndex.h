@@ -0,0 +1,55 @@
+//////////////////////////////////////////////////////////////////////////////
+// Seek index class
+//
+// Bit offsets of the codewords at every block_size() decoded bytes of an
+// encoded message, such that a range of the message can be decoded without
+// decoding everything before it. The index also records the exact number of
+// bytes in the message, which cannot be told from the padded encoding.
+// The index is stored in its own stream, like the key.
+//////////////////////////////////////////////////////////////////////////////
+#ifndef HEADER_SEEK_INDEX
+#define HEADER_SEEK_INDEX
+
+#include <vector>
+
+#include "ByteStream.h"
+
+class SeekIndex
+{
+	// Number of bytes preceding the offsets in a stored index
+	static const std::size_t header_size = 24;
+
+	public:
+		// Largest block size, which bounds the bytes decoded and discarded to reach a range
+		static const std::size_t max_block_size = 1 << 24;
+
+	private:
+		// Data members
+		std::size_t _blockSize;
+		unsigned long long _symbols;				// Bytes in the message
+		unsigned long long _bits;					// Codeword bits in the message (excluding padding)
+		std::vector<unsigned long long> _offsets;	// Bit offset of the first codeword of each block
+
+	public:
+		// Constructor / destructor
+		SeekIndex(std::size_t blockSize = 4096);
+		~SeekIndex();
+
+		// Building the index while encoding
+		void clear();
+		void add_block(unsigned long long bitOffset);
+		void add_coded(unsigned long long symbols, unsigned long long bits);
+
+		// Access methods
+		std::size_t block_size() const;
+		unsigned long long symbols() const;
+		unsigned long long bits() const;
+		std::size_t blocks() const;
+		unsigned long long block_offset(std::size_t block) const;
+
+		// Storing the index in a stream, load() returns false if the stream is not a valid index
+		void save(ByteStream& stream) const;
+		bool load(const ByteStream& stream);
+};
+
+#endif
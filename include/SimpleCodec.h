@@ -0,0 +1,162 @@
+//////////////////////////////////////////////////////////////////////////////
+// Simple compression codec class
+//
+// A key of the simple compression algorithm compiled into the tables used
+// for encoding and decoding. The key is parsed once, after which the codec
+// can encode or decode any number of messages without further setup.
+// A compiled codec is immutable, so it can be shared by any number of
+// threads without locking.
+// The encoding and decoding loops are compiled for each of the common
+// lengths of fixed length codewords, and the codec picks the loops
+// matching its key.
+//////////////////////////////////////////////////////////////////////////////
+#ifndef HEADER_CODEC_SIMPLE
+#define HEADER_CODEC_SIMPLE
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "ByteSink.h"
+#include "ByteStream.h"
+#include "ByteView.h"
+#include "SeekIndex.h"
+
+class SimpleCodec
+{
+	using codeword_pair = std::pair<int, unsigned short>;
+	using encoding_map = std::map<char, std::pair<int, unsigned short>>;
+
+	// Encoding table entry for a byte: its codeword and the length of the codeword (zero if the byte has no codeword)
+	struct encoding_entry
+	{
+		unsigned short codeword;
+		unsigned char bits;
+	};
+
+	// Decoding table entry for a peeked bit pattern: the decoded byte and the length of its codeword
+	struct decoding_entry
+	{
+		char symbol;
+		unsigned char bits;
+	};
+	using decoding_table = std::vector<decoding_entry>;
+
+	// Multi-symbol decoding table entry for a peeked bit pattern: all codewords that are complete within the pattern
+	// (upto multi_decoding_symbols), and their total length. A count of zero means the first codeword is longer than the pattern.
+	static const int multi_decoding_bits = 12;
+	static const int multi_decoding_symbols = 4;
+	struct multi_decoding_entry
+	{
+		char symbols[multi_decoding_symbols];
+		unsigned char count;
+		unsigned char bits;
+	};
+	using multi_decoding_table = std::vector<multi_decoding_entry>;
+
+	// Most lookups done in one batch. Each lookup reserves room for multi_decoding_symbols bytes in the output,
+	// so this bounds the room reserved beyond the decoded bytes.
+	static const int decoding_batch_lookups = 1 << 16;
+
+	// Number of bytes preceding the codewords in the key stream
+	static const std::size_t key_header_size = 6;
+
+	public:
+		// Bits of a partially written byte, carried between the parts of a message encoded in parts
+		struct encoding_state
+		{
+			unsigned long long bits;
+			int count;
+		};
+
+	private:
+		// Encoding / decoding loops, compiled for the length of fixed length codewords
+		using encode_kernel = bool (SimpleCodec::*)(ByteView, ByteSink&, encoding_state&, bool, SeekIndex*) const;
+		using decode_kernel = std::size_t (SimpleCodec::*)(ByteView, bitstream_index&, ByteSink&, std::size_t) const;
+		struct kernel_pair
+		{
+			encode_kernel encode;
+			decode_kernel decode;
+		};
+
+		// Loops are compiled for keys without long codewords, whose codewords have 2 to 7 bits. Other keys use loops
+		// reading the lengths at runtime, as the length of a codeword is then looked up anyway.
+		static const int kernel_min_bits = 2;
+		static const int kernel_max_bits = 7;
+
+		// Data members
+		int _bitsShort;
+		int _bitsLong;				// Zero if there are no extended codewords
+		int _tableBits;				// Number of bits indexing the decoding table
+		encoding_entry _encodingTable[256];
+		decoding_table _decodingTable;
+		multi_decoding_table _multiDecodingTable;
+		encode_kernel _encodeKernel;
+		decode_kernel _decodeKernel;
+		bool _specialized;			// Set if the loops are compiled for the codeword lengths of the key
+		unsigned int _keyId;		// Identifies the key the codec was compiled from
+
+		// Constructor (codecs are created by compiling a key)
+		SimpleCodec();
+
+		// Private methods
+		static bool ReadMapFromKeyStream(const ByteStream& keyStream, encoding_map& map, int& bits_short, int& bits_long);
+		void GetEncodingTable(const encoding_map& emap);
+		void GetDecodingTable(const encoding_map& emap);
+		void GetMultiDecodingTable();
+		static unsigned long long PeekBits(const char* data, std::size_t byte_index);
+		std::size_t DecodeBits(ByteView input, bitstream_index& bit_ptr, ByteSink& output, std::size_t maxSymbols) const;
+		void SelectKernels(bool specialized);
+
+		// Loops for codewords of the given fixed length, or of the lengths of the key if FixedBits is zero
+		template <int FixedBits>
+		bool EncodeKernel(ByteView input, ByteSink& output, encoding_state& state, bool final, SeekIndex* index) const;
+		template <int FixedBits>
+		std::size_t DecodeKernel(ByteView input, bitstream_index& bit_ptr, ByteSink& output, std::size_t maxSymbols) const;
+		template <std::size_t... Indices>
+		static const kernel_pair* KernelTable(std::index_sequence<Indices...>);
+
+	public:
+		// Decode until the end of the input
+		static const std::size_t all_symbols = static_cast<std::size_t>(-1);
+
+		// Destructor
+		~SimpleCodec();
+
+		// Factory method, returns an empty pointer if the key is not valid.
+		// Unless specialized is cleared, the loops compiled for the codeword lengths of the key are used if available.
+		static std::shared_ptr<const SimpleCodec> Compile(const ByteStream& keyStream, bool specialized = true);
+
+		// Returns the identifier of a key (a hash of the key stream), which may be stored with encoded messages
+		static unsigned int KeyId(const ByteStream& keyStream);
+
+		// Encoding / decoding of single messages, appending to the output. Decode() returns the number of bytes decoded.
+		bool Encode(ByteView input, ByteSink& output) const;
+		bool Encode(ByteView input, std::vector<char>& output) const;
+		std::size_t Decode(ByteView input, ByteSink& output, std::size_t maxSymbols = all_symbols) const;
+		std::size_t Decode(ByteView input, std::vector<char>& output, std::size_t maxSymbols = all_symbols) const;
+		std::size_t MaxEncodedSize(std::size_t size) const;
+
+		// Encoding of a message in consecutive parts (e.g. chunks of a file), where the last byte is
+		// only padded by the final part. The state must be zero-initialized for the first part.
+		bool Encode(ByteView input, ByteSink& output, encoding_state& state, bool final, SeekIndex* index = nullptr) const;
+
+		// Random access: encoding a message while building its seek index, and decoding a range of the message
+		bool Encode(ByteView input, ByteSink& output, SeekIndex& index) const;
+		bool DecodeRange(ByteView input, const SeekIndex& index, unsigned long long offset, std::size_t length, ByteSink& output) const;
+
+		// Encoding / decoding of many messages into one arena, with the offset of each message in the arena
+		// (and the end of the last message as the final offset). DecodeBatch() returns false if a message does not
+		// hold its number of bytes.
+		bool EncodeBatch(const std::vector<ByteView>& messages, std::vector<char>& arena, std::vector<std::size_t>& offsets) const;
+		bool DecodeBatch(const std::vector<ByteView>& messages, const std::vector<std::size_t>& sizes, std::vector<char>& arena, std::vector<std::size_t>& offsets) const;
+
+		// Key properties
+		int bits_short() const;
+		int bits_long() const;
+		bool specialized() const;
+		unsigned int key_id() const;
+};
+
+#endif
@@ -4,23 +4,29 @@
 #ifndef HEADER_COMPRESSION_SIMPLE
 #define HEADER_COMPRESSION_SIMPLE
 
-#include <map>
+#include <vector>
 
 #include "ByteStreamEncoder.h"
+#include "CodecCache.h"
+#include "SimpleCodec.h"
 
 class SimpleCompression : public ByteStreamEncoder
 {
-	using codeword_pair = std::pair<int, unsigned short>;
-	using encoding_map = std::map<char, std::pair<int, unsigned short>>;
-	using decoding_map = std::map<codeword_pair, unsigned int>;
+	// Number of bytes of the key id preceding the codewords, if key ids are embedded
+	static const std::size_t key_id_size = 4;
 
 	private:
 		// Data members
 		double _targetFraction;
+		std::shared_ptr<const SimpleCodec> _codec;		// Used instead of the key stream if set
+		SeekIndex* _seekIndex;							// Built when encoding and used when decoding, if set
+		CodecCache* _codecCache;						// Compiled keys are looked up in the cache, if set
+		bool _embedKeyId;								// Set if the encoding starts with the id of its key
 
 		// Private methods
-		bool ReadMapFromKeyStream(encoding_map& map, int& bits_short, int& bits_long);
-		void GetDecodingMap(const encoding_map& emap, decoding_map& dmap);
+		std::shared_ptr<const SimpleCodec> GetCodec() const;
+		std::shared_ptr<const SimpleCodec> GetDecodingCodec(ByteView& input) const;
+		bool BuildKey(const unsigned long long* frequency);
 
 	public:
 		// Constructor / destructor
@@ -28,14 +34,29 @@ class SimpleCompression : public ByteStreamEncoder
 		~SimpleCompression();
 
 		// Public ByteStreamEncoder interface
-		bool Encode() override;
-		bool Decode() override;
+		using ByteStreamEncoder::Encode;
+		using ByteStreamEncoder::Decode;
+		bool Encode(ByteView input, ByteSink& output) override;
+		bool Decode(ByteView input, ByteSink& output) override;
 		bool UsesKey() const override;
 		std::string Name() const override;
 		bool GenerateKey() override;
 
+		// Fills the key stream with a key trained on a corpus of sample messages, which can encode any message
+		bool TrainKey(const std::vector<ByteView>& samples);
+
 		// Other public methods
 		void SetTargetFraction(double targetFraction);
+		void SetCodec(std::shared_ptr<const SimpleCodec> codec);
+		void SetSeekIndex(SeekIndex* seekIndex);
+		void SetCodecCache(CodecCache* codecCache);
+		void SetEmbedKeyId(bool embedKeyId);
+
+		// Reads the key id from the start of an encoding with an embedded key id
+		static bool ReadKeyId(ByteView input, unsigned int& keyId);
+
+		// Decodes a range of bytes of the input stream into the output stream, using the seek index
+		bool DecodeRange(unsigned long long offset, std::size_t length);
 };
 
 #endif
\ No newline at end of file
@@ -1,21 +1,119 @@
 //////////////////////////////////////////////////////////////////////////////
 // Main file
 //////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 
 #include "include/ByteStream.h"
 #include "include/ByteStreamEncoder.h"
+#include "include/CodecCache.h"
+#include "include/DeltaFilter.h"
+#include "include/EncoderVerifier.h"
+#include "include/FilePipeline.h"
+#include "include/SeekIndex.h"
+#include "include/SimpleCodec.h"
 #include "include/SimpleCompression.h"
 
-int main()
+// Compares the throughput of the generic encoding/decoding loops with the loops compiled for the codeword lengths of the key
+void RunKernelBenchmark(const ByteStream& inputStream, const ByteStream& keyStream, int repetitions)
+{
+	const ByteView input{ inputStream.data(), inputStream.size() };
+	std::vector<char> encoded;
+	std::vector<char> decoded;
+
+	for (bool specialized : { false, true })
+	{
+		std::shared_ptr<const SimpleCodec> codec = SimpleCodec::Compile(keyStream, specialized);
+		if (!codec)
+			return;
+
+		std::chrono::duration<double> encode_time(0);
+		std::chrono::duration<double> decode_time(0);
+		std::size_t decoded_size = 0;
+		for (int i = 0; i < repetitions; i++)
+		{
+			encoded.clear();
+			decoded.clear();
+
+			const auto start = std::chrono::steady_clock::now();
+			codec->Encode(input, encoded);
+			const auto middle = std::chrono::steady_clock::now();
+			decoded_size = codec->Decode(ByteView{ encoded.data(), encoded.size() }, decoded, input.size);
+			const auto end = std::chrono::steady_clock::now();
+
+			encode_time += middle - start;
+			decode_time += end - middle;
+		}
+
+		const double megabytes = static_cast<double>(input.size) * repetitions / 1e6;
+		std::cout << "  - " << (codec->specialized() ? "Specialized" : "Generic") << " loops (" << codec->bits_short() << "/" << codec->bits_long() << " bits): ";
+		std::cout << "encode " << megabytes / encode_time.count() << " MB/s, decode " << megabytes / decode_time.count() << " MB/s";
+		std::cout << ((decoded_size == input.size && std::equal(decoded.cbegin(), decoded.cend(), input.data)) ? "" : " (round-trip failed!)") << "\n";
+	}
+	std::cout << std::endl;
+}
+
+int main(int argc, char* argv[])
 {
 	bool generate_key = true;
+	bool file_pipeline = true;		// Also encode the file directly from disk to disk
+	bool embed_key_id = false;		// Start the encoded file with the id of its key
+	bool run_benchmark = false;		// Compare the generic and specialized encoding/decoding loops
+	bool run_self_check = false;	// Round-trip generated inputs, and compare the optimized coding with the reference implementation
+	bool run_large_input_check = false;	// Encode and decode a sparse file above 4 GiB (needs memory for the whole file)
+
+	// The checks and the benchmark can also be switched on from the command line
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string option = argv[i];
+		if (option == "--self-check")
+			run_self_check = true;
+		else if (option == "--large-input-check")
+			run_large_input_check = true;
+		else if (option == "--benchmark")
+			run_benchmark = true;
+		else
+			std::cout << "Unknown option \"" << option << "\" ignored." << std::endl;
+	}
+
+	if (run_self_check)
+	{
+		EncoderVerifier verifier;
+		if (verifier.Run(100))
+		{
+			std::cout << "Self-check passed (" << verifier.Checks() << " checks).\n" << std::endl;
+		}
+		else
+		{
+			for (auto i = verifier.Failures().cbegin(); i != verifier.Failures().cend(); i++)
+				std::cout << "Self-check failed: " << *i << "\n";
+			std::cout << std::endl;
+		}
+	}
+
+	if (run_large_input_check)
+	{
+		EncoderVerifier verifier;
+		if (verifier.CheckLargeInput("../assets/large_input.bin"))
+		{
+			std::cout << "Large input check passed (" << verifier.Checks() << " checks).\n" << std::endl;
+		}
+		else
+		{
+			for (auto i = verifier.Failures().cbegin(); i != verifier.Failures().cend(); i++)
+				std::cout << "Large input check failed: " << *i << "\n";
+			std::cout << std::endl;
+		}
+	}
 
 	// Filenames used for testing
 	const std::string in_testfile = "../assets/molspin_source.txt";
 	const std::string out_encoded_testfile = "../assets/molspin_source.encoded";
 	const std::string out_decoded_testfile = "../assets/molspin_source.decoded";
+	const std::string out_pipeline_testfile = "../assets/molspin_source.pipeline.encoded";
 	const std::string keyfile = "../assets/encoding_map.key";
+	const std::string indexfile = "../assets/molspin_source.index";
 
 	// Setup byte stream for a file
 	ByteStream inputStream;
@@ -33,8 +131,15 @@ int main()
 	// And a key stream
 	ByteStream keyStream;
 
-	// Setup compression algorithm
-	std::unique_ptr<ByteStreamEncoder> encoder = std::make_unique<SimpleCompression>(inputStream, outputStream, keyStream);
+	// Setup compression algorithm, with a seek index for decoding ranges of the encoded file,
+	// and a cache of compiled keys such that the key is only parsed once
+	SeekIndex seekIndex;
+	CodecCache codecCache;
+	std::unique_ptr<SimpleCompression> simpleCompression = std::make_unique<SimpleCompression>(inputStream, outputStream, keyStream);
+	simpleCompression->SetSeekIndex(&seekIndex);
+	simpleCompression->SetCodecCache(&codecCache);
+	simpleCompression->SetEmbedKeyId(embed_key_id);
+	ByteStreamEncoder* encoder = simpleCompression.get();
 
 	// Generate a key
 	if (generate_key)
@@ -66,7 +171,16 @@ int main()
 		std::cout << "\n--- Input file statistics:\n";
 		std::cout << "  - File size: " << inputStream.size() << " bytes\n";
 		std::cout << "  - File entropy (bytes): " << inputStream.byte_entropy() << " bits\n";
-		std::cout << "  - File entropy (bits): " << inputStream.bit_entropy() << " bits\n" << std::endl;
+		std::cout << "  - File entropy (bits): " << inputStream.bit_entropy() << " bits\n";
+
+		// Numeric data may compress better after a delta filter
+		DeltaFilter::Mode filter_mode;
+		unsigned int filter_stride;
+		DeltaFilter::ChooseFilter(ByteView{ inputStream.data(), inputStream.size() }, filter_mode, filter_stride);
+		if (filter_mode == DeltaFilter::Mode::None)
+			std::cout << "  - Pre-filter: none (filtering does not lower the entropy)\n" << std::endl;
+		else
+			std::cout << "  - Pre-filter: " << ((filter_mode == DeltaFilter::Mode::Delta) ? "delta" : "XOR") << " of " << filter_stride << " byte words\n" << std::endl;
 
 		// Perform the byte stream manipulations
 		if (encoder->Encode())
@@ -78,20 +192,32 @@ int main()
 			// Output file statistics
 			std::cout << "--- Encoded output file statistics:\n";
 			std::cout << "  - Algorithm: " << encoder->Name() << "\n";
+			std::cout << "  - Key id: " << SimpleCodec::KeyId(keyStream) << (embed_key_id ? " (embedded)" : "") << "\n";
 			std::cout << "  - File size: " << outputStream.size() << " bytes\n";
 			std::cout << "  - Compression ratio: " << compression_ratio << "\n";
 			std::cout << "  - File size reduction: " << (100.0 - compression_ratio * 100.0) << "%\n";
 			std::cout << "  - File entropy (bytes): " << outputStream.byte_entropy() << " bits\n";
 			std::cout << "  - File entropy (bits): " << outputStream.bit_entropy() << " bits\n" << std::endl;
 
-			// Write the output stream to a file
+			// Write the output stream and its seek index to files
 			outputStream.save(out_encoded_testfile);
+
+			ByteStream indexStream;
+			seekIndex.save(indexStream);
+			indexStream.save(indexfile);
 		}
 		else
 		{
 			std::cout << "Failed to encode file!" << std::endl;
 		}
 
+		// Compare the encoding/decoding loops on the input file
+		if (run_benchmark)
+		{
+			std::cout << "--- Benchmark:\n";
+			RunKernelBenchmark(inputStream, keyStream, 20);
+		}
+
 		// Also decode the file again
 		std::cout << " -------- Decoding file --------" << std::endl;
 		inputStream = outputStream;
@@ -113,6 +239,37 @@ int main()
 		{
 			std::cout << "Failed to decode file!" << std::endl;
 		}
+
+		// Decode a few bytes from the middle of the file, without decoding the bytes before them
+		const unsigned long long range_offset = seekIndex.symbols() / 2;
+		const std::size_t range_length = static_cast<std::size_t>(std::min(seekIndex.symbols() - range_offset, 32ULL));
+		if (simpleCompression->DecodeRange(range_offset, range_length))
+			std::cout << "Decoded bytes " << range_offset << " to " << (range_offset + range_length) << " using the seek index: \"" << std::string(outputStream.data(), outputStream.size()) << "\"\n" << std::endl;
+		else
+			std::cout << "Failed to decode a range of the file!\n" << std::endl;
+
+		// Timing and key properties collected by the encoder
+		std::cout << "--- Encoder metrics:\n" << encoder->Metrics().to_json() << "\n";
+		std::cout << "  - Codec cache: " << codecCache.hits() << " hits, " << codecCache.misses() << " misses\n" << std::endl;
+
+		// Encode the file again, overlapping reading, encoding and writing
+		std::shared_ptr<const SimpleCodec> codec = codecCache.Get(keyStream);
+		if (file_pipeline && codec)
+		{
+			std::cout << " -------- File pipeline --------" << std::endl;
+			FilePipeline pipeline(codec);
+
+			const auto start = std::chrono::steady_clock::now();
+			const bool encoded = pipeline.EncodeFile(in_testfile, out_pipeline_testfile);
+			const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+			if (encoded)
+				std::cout << "Encoded file \"" << in_testfile << "\" to \"" << out_pipeline_testfile << "\" in " << wall.count() << " seconds.\n" << std::endl;
+			else
+				std::cout << "Failed to encode file \"" << in_testfile << "\" to \"" << out_pipeline_testfile << "\"!\n" << std::endl;
+
+			std::cout << "--- Pipeline metrics:\n" << pipeline.Metrics().to_json() << "\n" << std::endl;
+		}
 	}
 	else
 	{
@@ -0,0 +1,131 @@
+//////////////////////////////////////////////////////////////////////////////
+// Byte sink implementations
+//////////////////////////////////////////////////////////////////////////////
+#include <cassert>
+
+#include "..\include\ByteSink.h"
+
+// ---------------------------------------------------------------------------
+// Byte sink
+// ---------------------------------------------------------------------------
+// Constructor
+ByteSink::ByteSink()
+{
+}
+
+// Destructor
+ByteSink::~ByteSink()
+{
+}
+
+// Growable sinks have no practical limit
+std::size_t ByteSink::room() const
+{
+	return static_cast<std::size_t>(-1);
+}
+
+// ---------------------------------------------------------------------------
+// Vector sink
+// ---------------------------------------------------------------------------
+// Constructor
+VectorSink::VectorSink(std::vector<char>& vector) : _vector(vector), _initial(vector.size()), _reserved(vector.size())
+{
+}
+
+// Destructor
+VectorSink::~VectorSink()
+{
+}
+
+// Grows the vector by the requested number of bytes
+char* VectorSink::reserve(std::size_t size)
+{
+	_reserved = _vector.size();
+	_vector.resize(_reserved + size);
+	return _vector.data() + _reserved;
+}
+
+// Shrinks the vector to the bytes written
+void VectorSink::commit(std::size_t size)
+{
+	assert(_reserved + size <= _vector.size());
+	_vector.resize(_reserved + size);
+}
+
+std::size_t VectorSink::written() const
+{
+	return _vector.size() - _initial;
+}
+
+// ---------------------------------------------------------------------------
+// Span sink
+// ---------------------------------------------------------------------------
+// Constructor
+SpanSink::SpanSink(char* data, std::size_t capacity) : _data(data), _capacity(capacity), _size(0)
+{
+}
+
+// Destructor
+SpanSink::~SpanSink()
+{
+}
+
+// Returns the unwritten part of the buffer, if it is large enough
+char* SpanSink::reserve(std::size_t size)
+{
+	if (size > _capacity - _size)
+		return nullptr;
+
+	return _data + _size;
+}
+
+void SpanSink::commit(std::size_t size)
+{
+	assert(size <= _capacity - _size);
+	_size += size;
+}
+
+std::size_t SpanSink::room() const
+{
+	return _capacity - _size;
+}
+
+std::size_t SpanSink::written() const
+{
+	return _size;
+}
+
+// ---------------------------------------------------------------------------
+// Byte stream sink
+// ---------------------------------------------------------------------------
+// Constructor
+ByteStreamSink::ByteStreamSink(ByteStream& stream) : _stream(stream), _initial(stream.size()), _reserved(stream.size())
+{
+}
+
+// Destructor
+ByteStreamSink::~ByteStreamSink()
+{
+}
+
+// Grows the stream by the requested number of bytes
+char* ByteStreamSink::reserve(std::size_t size)
+{
+	_reserved = _stream.size();
+	_stream.resize(_reserved + size);
+	return _stream.data() + _reserved;
+}
+
+// Shrinks the stream to the bytes written
+void ByteStreamSink::commit(std::size_t size)
+{
+	assert(_reserved + size <= _stream.size());
+	_stream.resize(_reserved + size);
+}
+
+std::size_t ByteStreamSink::written() const
+{
+	return _stream.size() - _initial;
+}
+
+// ---------------------------------------------------------------------------
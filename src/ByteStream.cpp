@@ -1,8 +1,11 @@
 //////////////////////////////////////////////////////////////////////////////
 // Byte stream implementation
 //////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <fstream>
+#include <thread>
 
 #include "..\include\ByteStream.h"
 
@@ -10,12 +13,12 @@
 // Constructor / destructor
 // ---------------------------------------------------------------------------
 // Constructor
-ByteStream::ByteStream() : _data(), _nextBit(0), _byteFrequency{0}, _byteProbability{0}, _bytesChanged(true)
+ByteStream::ByteStream() : _data(), _nextBit(0), _byteFrequency{0}, _byteProbability{0}, _bytesChanged(true), _setBits(0), _contextOrder(0)
 {
 }
 
 // Copy-constructor
-ByteStream::ByteStream(const ByteStream& stream) : _data(stream._data), _nextBit(stream._nextBit), _byteFrequency{0}, _byteProbability{0}, _bytesChanged(true)
+ByteStream::ByteStream(const ByteStream& stream) : _data(stream._data), _nextBit(stream._nextBit), _byteFrequency{0}, _byteProbability{0}, _bytesChanged(true), _setBits(0), _contextOrder(stream._contextOrder)
 {
 }
 
@@ -30,13 +33,13 @@ ByteStream::~ByteStream()
 // Indexing operator
 // NOTE: Provides direct access to internal resource managed by the stream.
 //       This is intended, but such access is not setting the dirty flag!
-char& ByteStream::operator[](unsigned int index)
+char& ByteStream::operator[](std::size_t index)
 {
 	return _data[index];
 }
 
 // Const version
-const char ByteStream::operator[](unsigned int index) const
+const char ByteStream::operator[](std::size_t index) const
 {
 	return _data[index];
 }
@@ -47,6 +50,7 @@ const ByteStream& ByteStream::operator=(const ByteStream& stream)
 	_data = stream._data;
 	_nextBit = stream._nextBit;
 	_bytesChanged = true;
+	_contextOrder = stream._contextOrder;
 	return *this;
 }
 
@@ -56,21 +60,161 @@ const ByteStream& ByteStream::operator=(const ByteStream& stream)
 // Update internal data members when the bytes are changed
 void ByteStream::BytesChanged()
 {
-	// Reset byte frequencies
-	memset(_byteFrequency, 0, sizeof(unsigned int) * 256);
-
-	// Compute byte frequencies
-	for (auto i = _data.cbegin(); i != _data.cend(); i++)
-		++_byteFrequency[static_cast<unsigned int>(*i) & 0xFF];
+	// Compute byte frequencies (and context frequencies if requested)
+	GatherStatistics();
 
 	// Get probabilities
 	for (auto i = 0; i < 256; i++)
 		_byteProbability[i] = static_cast<double>(_byteFrequency[i]) / static_cast<double>(_data.size());
 
+	// The number of set bits follows from the byte frequencies
+	_setBits = 0;
+	for (auto i = 0; i < 256; i++)
+	{
+		unsigned int bits = 0;
+		for (auto byte = i; byte != 0; byte >>= 1)
+			bits += byte & 1;
+
+		_setBits += bits * _byteFrequency[i];
+	}
+
 	// Reset dirty flag
 	_bytesChanged = false;
 }
 
+// Gathers the byte histogram, and the order-1 and order-2 context histograms, in a single pass over the data.
+// Large streams are split across threads, each counting into its own histograms,
+// which are summed afterwards (each thread summing a slice of the counters).
+// The calling thread takes the first chunk and slice itself.
+// NOTE: Where the pages of the data are placed on machines with several memory nodes is left to the system.
+void ByteStream::GatherStatistics()
+{
+	const std::size_t order0_size = 256;
+	const std::size_t order1_size = (_contextOrder > 0) ? 256 * 256 : 0;
+	const std::size_t order2_size = (_contextOrder > 1) ? (static_cast<std::size_t>(1) << order2_context_bits) * 256 : 0;
+	const std::size_t histogram_size = order0_size + order1_size + order2_size;
+
+	// Each thread needs its own histograms, so give each thread more data when the histograms are large
+	const std::size_t bytes_per_thread = (_contextOrder > 0) ? (1 << 22) : (1 << 20);
+	std::size_t thread_count = std::min<std::size_t>(std::thread::hardware_concurrency(), _data.size() / bytes_per_thread);
+	if (thread_count < 1)
+		thread_count = 1;
+
+	// Count a chunk of the data into a per-thread histogram
+	std::vector<std::vector<unsigned long long>> partial(thread_count);
+	const std::size_t chunk_size = _data.size() / thread_count;
+	auto count = [&](std::size_t t)
+	{
+		const std::size_t first = t * chunk_size;
+		const std::size_t last = (t + 1 == thread_count) ? _data.size() : first + chunk_size;
+
+		partial[t].assign(histogram_size, 0);
+		CountBytes(_data.data(), first, last, _contextOrder, partial[t].data());
+	};
+
+	// Sum a slice of the per-thread histograms into the first one
+	const std::size_t slice_size = histogram_size / thread_count;
+	auto reduce = [&](std::size_t t)
+	{
+		const std::size_t first = t * slice_size;
+		const std::size_t last = (t + 1 == thread_count) ? histogram_size : first + slice_size;
+
+		for (std::size_t p = 1; p < thread_count; p++)
+			for (std::size_t i = first; i < last; i++)
+				partial[0][i] += partial[p][i];
+	};
+
+	if (thread_count == 1)
+	{
+		count(0);
+	}
+	else
+	{
+		std::vector<std::thread> workers;
+		for (std::size_t t = 1; t < thread_count; t++)
+			workers.emplace_back(count, t);
+		count(0);
+		for (auto& worker : workers)
+			worker.join();
+
+		workers.clear();
+		for (std::size_t t = 1; t < thread_count; t++)
+			workers.emplace_back(reduce, t);
+		reduce(0);
+		for (auto& worker : workers)
+			worker.join();
+	}
+
+	auto histogram = partial[0].cbegin();
+	std::copy(histogram, histogram + order0_size, _byteFrequency);
+	_order1Frequency.assign(histogram + order0_size, histogram + order0_size + order1_size);
+	_order2Frequency.assign(histogram + order0_size + order1_size, partial[0].cend());
+}
+
+// Counts the bytes, and the context/byte pairs up to the given order, in the range [first, last) of the data.
+// The histogram holds the byte counters followed by the order-1 and order-2 counters.
+// The stream is treated as if it is preceded by zero bytes.
+// The order-2 context keeps the preceding byte, so it splits each order-1 context and its entropy is never higher.
+void ByteStream::CountBytes(const char* data, std::size_t first, std::size_t last, unsigned short order, unsigned long long* histogram)
+{
+	static_assert(order2_context_bits > 8 && order2_context_bits <= 16, "The order-2 context holds the preceding byte and a hash");
+	const unsigned int hash_bits = order2_context_bits - 8;
+
+	unsigned long long* order0 = histogram;
+	unsigned long long* order1 = order0 + 256;
+	unsigned long long* order2 = order1 + 256 * 256;
+
+	// Plain byte counting does not need to track the preceding bytes
+	if (order == 0)
+	{
+		for (std::size_t i = first; i < last; i++)
+			++order0[static_cast<unsigned char>(data[i])];
+		return;
+	}
+
+	unsigned int previous1 = (first > 0) ? static_cast<unsigned char>(data[first - 1]) : 0;
+	unsigned int previous2 = (first > 1) ? static_cast<unsigned char>(data[first - 2]) : 0;
+
+	for (std::size_t i = first; i < last; i++)
+	{
+		const unsigned int byte = static_cast<unsigned char>(data[i]);
+		++order0[byte];
+		++order1[(previous1 << 8) | byte];
+
+		if (order > 1)
+		{
+			// The preceding byte, and a multiplicative hash of the byte before it
+			const unsigned int context = (previous1 << hash_bits) | (((previous2 * 0x9E3779B1u) & 0xFFFFFFFFu) >> (32 - hash_bits));
+			++order2[(context << 8) | byte];
+		}
+
+		previous2 = previous1;
+		previous1 = byte;
+	}
+}
+
+// Calculates the entropy of a byte given its context, from a histogram with 256 counters per context
+double ByteStream::ConditionalEntropy(const std::vector<unsigned long long>& frequency, std::size_t total)
+{
+	if (total == 0)
+		return 0;
+
+	double entropy = 0;
+	for (std::size_t context = 0; context < frequency.size(); context += 256)
+	{
+		// Number of times the context occurs
+		unsigned long long context_total = 0;
+		for (std::size_t i = context; i < context + 256; i++)
+			context_total += frequency[i];
+
+		for (std::size_t i = context; i < context + 256; i++)
+			if (frequency[i] > 0)
+				entropy -= static_cast<double>(frequency[i]) * std::log2(static_cast<double>(frequency[i]) / static_cast<double>(context_total));
+	}
+
+	return entropy / static_cast<double>(total);
+}
+
 // ---------------------------------------------------------------------------
 // Iterators
 // ---------------------------------------------------------------------------
@@ -120,28 +264,15 @@ double ByteStream::bit_entropy() const
 	// Make sure the statistics are prepared
 	assert(!_bytesChanged);
 
-	// Get the entropy
-	unsigned int ones = 0;
-	for (auto i = _data.cbegin(); i != _data.cend(); i++)
-	{
-		ones += (*i & 0b00000001) ? 1 : 0;
-		ones += (*i & 0b00000010) ? 1 : 0;
-		ones += (*i & 0b00000100) ? 1 : 0;
-		ones += (*i & 0b00001000) ? 1 : 0;
-		ones += (*i & 0b00010000) ? 1 : 0;
-		ones += (*i & 0b00100000) ? 1 : 0;
-		ones += (*i & 0b01000000) ? 1 : 0;
-		ones += (*i & 0b10000000) ? 1 : 0;
-	}
-
-	double one_probability = (static_cast<double>(ones) / static_cast<double>(_data.size())) / 8.0;
+	// Get the entropy from the number of set bits
+	double one_probability = (static_cast<double>(_setBits) / static_cast<double>(_data.size())) / 8.0;
 	double zero_probability = 1.0 - one_probability;
 
 	return -one_probability * std::log2(one_probability) - zero_probability * std::log2(zero_probability);
 }
 
 // Returns the number of times a specific byte value is present in the byte stream
-unsigned int ByteStream::byte_frequency(int byte) const
+unsigned long long ByteStream::byte_frequency(int byte) const
 {
 	// Make sure the byte index is valid
 	assert(byte >= 0 && byte < 256);
@@ -176,6 +307,43 @@ double ByteStream::byte_information_content(int byte) const
 	return -std::log2(_byteProbability[byte]);
 }
 
+// Calculates the Shannon entropy of the bytes given the preceding bytes (order 0 is the plain byte entropy).
+// NOTE: Order 2 contexts are hashed, so colliding contexts make the result an upper bound.
+double ByteStream::conditional_entropy(unsigned short order) const
+{
+	// Make sure the statistics for the order are gathered
+	assert(order <= _contextOrder);
+
+	// Make sure the statistics are prepared
+	assert(!_bytesChanged);
+
+	if (order == 0)
+		return byte_entropy();
+
+	return ConditionalEntropy((order == 1) ? _order1Frequency : _order2Frequency, _data.size());
+}
+
+// Returns the highest context order for which statistics are gathered
+unsigned short ByteStream::context_order() const
+{
+	return _contextOrder;
+}
+
+// Sets the highest context order (0 to 2) for which statistics are gathered on the next update
+void ByteStream::set_context_order(unsigned short order)
+{
+	assert(order <= 2);
+
+	_contextOrder = order;
+	_bytesChanged = true;
+
+	// Release histograms that are no longer gathered
+	if (order < 2)
+		std::vector<unsigned long long>().swap(_order2Frequency);
+	if (order < 1)
+		std::vector<unsigned long long>().swap(_order1Frequency);
+}
+
 // ---------------------------------------------------------------------------
 // Population methods
 // ---------------------------------------------------------------------------
@@ -226,6 +394,21 @@ void ByteStream::put(char datum, unsigned short bits)
 	}
 }
 
+// Adds a number of whole bytes to the stream, which must not contain an unfinished byte
+void ByteStream::append(const char* bytes, std::size_t count)
+{
+	assert(_nextBit == 0);
+	_data.insert(_data.end(), bytes, bytes + count);
+}
+
+// Sets the number of whole bytes in the stream, new bytes being zero
+void ByteStream::resize(std::size_t size)
+{
+	_data.resize(size);
+	_nextBit = 0;
+	_bytesChanged = true;
+}
+
 // Read upto 8 bits from the stream, from a given bit index
 char ByteStream::read(bitstream_index firstBit, unsigned short bits) const
 {
@@ -242,7 +425,7 @@ char ByteStream::read(bitstream_index firstBit, unsigned short bits) const
 	auto bit_index = firstBit % 8;
 
 	// Get the requested bits from the byte with the first bit
-	assert(_data.size() > byte_index);
+	assert(static_cast<bitstream_index>(_data.size()) > byte_index);
 	char result = _data[byte_index] << bit_index;
 
 	int shift = 8 - (bits + bit_index);
@@ -252,7 +435,7 @@ char ByteStream::read(bitstream_index firstBit, unsigned short bits) const
 	}
 	else
 	{
-		assert(_data.size() > byte_index + 1);
+		assert(static_cast<bitstream_index>(_data.size()) > byte_index + 1);
 		char bitsFromNextByte = _data[byte_index + 1] & (0xFF << (8+shift));
 		result |= (bitsFromNextByte >> (8 - bit_index)) & (0xFF >> (8 - bit_index));
 	}
@@ -302,16 +485,16 @@ bool ByteStream::load(const std::string& filename)
 
 	// Get file size and allocate memory
 	filehandle.seekg(0, filehandle.end);
-	unsigned int filesize = filehandle.tellg();
+	const std::streamoff filesize = filehandle.tellg();
 	filehandle.seekg(0, filehandle.beg);
-	_data.reserve(filesize);
+	if (filesize < 0 || static_cast<unsigned long long>(filesize) > _data.max_size())
+		return false;
+	_data.resize(static_cast<std::size_t>(filesize));
 
 	// Read bytes
-	char c;
-	while (filehandle.get(c))
-		_data.push_back(c);
+	filehandle.read(_data.data(), static_cast<std::streamsize>(filesize));
 
-	return true;
+	return filehandle.gcount() == filesize;
 }
 
 // Saves the content of the buffer to a file
@@ -322,15 +505,28 @@ bool ByteStream::save(const std::string& filename)
 	if (!filehandle.good() || !filehandle.is_open())
 		return false;
 
-	for (auto i = _data.cbegin(); i != _data.cend(); i++)
-		filehandle.put(*i);
+	filehandle.write(_data.data(), static_cast<std::streamsize>(_data.size()));
 
-	return true;
+	return filehandle.good();
 }
 
 // Returns the number of bytes in the stream
-unsigned int ByteStream::size() const
+std::size_t ByteStream::size() const
 {
 	return _data.size();
 }
+
+// Returns a pointer to the bytes in the stream
+// NOTE: Provides direct access to internal resource managed by the stream.
+const char* ByteStream::data() const
+{
+	return _data.data();
+}
+
+// NOTE: Provides direct access to internal resource managed by the stream.
+//       This is intended, but such access is not setting the dirty flag!
+char* ByteStream::data()
+{
+	return _data.data();
+}
 // ---------------------------------------------------------------------------
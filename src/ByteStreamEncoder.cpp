@@ -10,9 +10,10 @@
 // ---------------------------------------------------------------------------
 // Constructor
 ByteStreamEncoder::ByteStreamEncoder(const ByteStream& inStream, ByteStream& outStream, ByteStream& keyStream)
-	:	_inStream(inStream),
-		_outStream(outStream),
-		_keyStream(keyStream)
+	:	_inStream(&inStream),
+		_outStream(&outStream),
+		_keyStream(&keyStream),
+		_metrics()
 {
 }
 
@@ -24,6 +25,40 @@ ByteStreamEncoder::~ByteStreamEncoder()
 // ---------------------------------------------------------------------------
 // Public interface
 // ---------------------------------------------------------------------------
+// Encodes the input stream into the output stream
+bool ByteStreamEncoder::Encode()
+{
+	// Clear the output stream
+	_outStream->clear();
+
+	ByteStreamSink sink(*_outStream);
+	if (!Encode(ByteView{ _inStream->data(), _inStream->size() }, sink))
+		return false;
+
+	// Update outstream statistics
+	ENCODER_METRICS_PHASE(_metrics, EncoderPhase::StatsUpdate);
+	_outStream->bytes_changed();
+
+	return true;
+}
+
+// Decodes the input stream into the output stream
+bool ByteStreamEncoder::Decode()
+{
+	// Clear the output stream
+	_outStream->clear();
+
+	ByteStreamSink sink(*_outStream);
+	if (!Decode(ByteView{ _inStream->data(), _inStream->size() }, sink))
+		return false;
+
+	// Update outstream statistics
+	ENCODER_METRICS_PHASE(_metrics, EncoderPhase::StatsUpdate);
+	_outStream->bytes_changed();
+
+	return true;
+}
+
 // Not all encoders have to use keys
 bool ByteStreamEncoder::GenerateKey()
 {
@@ -35,8 +70,21 @@ bool ByteStreamEncoder::GenerateKey()
 // Public methods
 // ---------------------------------------------------------------------------
 // Keys may be read/written on decoding/encoding if keys are used
+// NOTE: The encoder uses the given stream from now on, the previous key stream is left untouched.
 void ByteStreamEncoder::SetKeyStream(ByteStream& keyStream)
 {
-	_keyStream = keyStream;
+	_keyStream = &keyStream;
+}
+
+// Returns the metrics collected by the encoder since construction or the last reset
+const EncoderMetrics& ByteStreamEncoder::Metrics() const
+{
+	return _metrics;
+}
+
+// Discards the collected metrics
+void ByteStreamEncoder::ResetMetrics()
+{
+	_metrics.clear();
 }
 // ---------------------------------------------------------------------------
@@ -0,0 +1,134 @@
+//////////////////////////////////////////////////////////////////////////////
+// Codec cache implementation
+//////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cassert>
+
+#include "..\include\CodecCache.h"
+
+// ---------------------------------------------------------------------------
+// Constructor / destructor
+// ---------------------------------------------------------------------------
+// Constructor
+CodecCache::CodecCache(std::size_t capacity) : _capacity(capacity), _codecs(), _ids(), _hits(0), _misses(0), _mutex()
+{
+	assert(_capacity > 0);
+}
+
+// Destructor
+CodecCache::~CodecCache()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Private methods
+// ---------------------------------------------------------------------------
+// Moves a codec to the front of the list (the mutex must be locked)
+void CodecCache::Touch(codec_list::iterator codec)
+{
+	_codecs.splice(_codecs.begin(), _codecs, codec);
+}
+
+// ---------------------------------------------------------------------------
+// Lookup
+// ---------------------------------------------------------------------------
+// A cached key with the same id is only used if its bytes are those of the key.
+// Keys are compiled without holding the lock, so other threads are not kept waiting.
+std::shared_ptr<const SimpleCodec> CodecCache::Get(const ByteStream& keyStream)
+{
+	const unsigned int key_id = SimpleCodec::KeyId(keyStream);
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto i = _ids.find(key_id);
+		if (i != _ids.end() && i->second->key.size() == keyStream.size() && std::equal(i->second->key.cbegin(), i->second->key.cend(), keyStream.cbegin()))
+		{
+			++_hits;
+			Touch(i->second);
+			return i->second->codec;
+		}
+		++_misses;
+	}
+
+	std::shared_ptr<const SimpleCodec> codec = SimpleCodec::Compile(keyStream);
+	if (codec)
+		Add(keyStream, codec);
+
+	return codec;
+}
+
+std::shared_ptr<const SimpleCodec> CodecCache::Find(unsigned int keyId)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto i = _ids.find(keyId);
+	if (i == _ids.end())
+	{
+		++_misses;
+		return nullptr;
+	}
+
+	++_hits;
+	Touch(i->second);
+	return i->second->codec;
+}
+
+// Adds a codec as the most recently used, replacing a codec with the same key id
+void CodecCache::Add(const ByteStream& keyStream, std::shared_ptr<const SimpleCodec> codec)
+{
+	assert(codec);
+	assert(codec->key_id() == SimpleCodec::KeyId(keyStream));
+	cache_entry entry{ std::vector<char>(keyStream.cbegin(), keyStream.cend()), codec };
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto i = _ids.find(codec->key_id());
+	if (i != _ids.end())
+	{
+		*i->second = std::move(entry);
+		Touch(i->second);
+		return;
+	}
+
+	// Drop the least recently used codec if the cache is full
+	if (_codecs.size() == _capacity)
+	{
+		_ids.erase(_codecs.back().codec->key_id());
+		_codecs.pop_back();
+	}
+
+	_codecs.push_front(std::move(entry));
+	_ids[codec->key_id()] = _codecs.begin();
+}
+
+// ---------------------------------------------------------------------------
+// Access methods
+// ---------------------------------------------------------------------------
+// Drops all codecs, keeping the hit and miss counts
+void CodecCache::clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_ids.clear();
+	_codecs.clear();
+}
+
+std::size_t CodecCache::size() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _codecs.size();
+}
+
+std::size_t CodecCache::capacity() const
+{
+	return _capacity;
+}
+
+unsigned long long CodecCache::hits() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _hits;
+}
+
+unsigned long long CodecCache::misses() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _misses;
+}
+// ---------------------------------------------------------------------------
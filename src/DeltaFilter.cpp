@@ -0,0 +1,252 @@
+//////////////////////////////////////////////////////////////////////////////
+// Delta filter implementation
+//////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include "..\include\DeltaFilter.h"
+
+// ---------------------------------------------------------------------------
+// Constructor / destructor
+// ---------------------------------------------------------------------------
+// Constructor (the filter is chosen from the input by default)
+DeltaFilter::DeltaFilter(const ByteStream& inStream, ByteStream& outStream, ByteStream& keyStream)
+	:	ByteStreamEncoder(inStream, outStream, keyStream),
+		_mode(Mode::Delta),
+		_stride(0)
+{
+}
+
+// Destructor
+DeltaFilter::~DeltaFilter()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Private methods
+// ---------------------------------------------------------------------------
+bool DeltaFilter::ValidStride(unsigned int stride)
+{
+	return stride == 1 || stride == 2 || stride == 4 || stride == 8;
+}
+
+// Replaces each word by its difference from the previous word. Every iteration only reads the input,
+// so the compiler can vectorize the loop.
+template <typename Word>
+void DeltaFilter::DeltaWords(const char* input, char* output, std::size_t words)
+{
+	if (words == 0)
+		return;
+
+	std::memcpy(output, input, sizeof(Word));
+	for (std::size_t i = 1; i < words; i++)
+	{
+		Word previous;
+		Word current;
+		std::memcpy(&previous, input + (i - 1) * sizeof(Word), sizeof(Word));
+		std::memcpy(&current, input + i * sizeof(Word), sizeof(Word));
+
+		const Word difference = static_cast<Word>(current - previous);
+		std::memcpy(output + i * sizeof(Word), &difference, sizeof(Word));
+	}
+}
+
+// Sums the differences to get the words back
+template <typename Word>
+void DeltaFilter::UndeltaWords(const char* input, char* output, std::size_t words)
+{
+	Word sum = 0;
+	for (std::size_t i = 0; i < words; i++)
+	{
+		Word difference;
+		std::memcpy(&difference, input + i * sizeof(Word), sizeof(Word));
+
+		sum = static_cast<Word>(sum + difference);
+		std::memcpy(output + i * sizeof(Word), &sum, sizeof(Word));
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Public ByteStreamEncoder interface
+// ---------------------------------------------------------------------------
+// Filters the input, after a byte with the filter (upper four bits) and the word size (lower four bits)
+bool DeltaFilter::Encode(ByteView input, ByteSink& output)
+{
+	Mode mode = _mode;
+	unsigned int stride = _stride;
+	if (stride == 0)
+	{
+		ENCODER_METRICS_PHASE(_metrics, EncoderPhase::KeyBuild);
+		ChooseFilter(input, mode, stride);
+	}
+
+	{
+		ENCODER_METRICS_PHASE(_metrics, EncoderPhase::EncodeLoop);
+		char* buffer = output.reserve(input.size + 1);
+		if (buffer == nullptr)
+			return false;
+
+		buffer[0] = static_cast<char>((static_cast<unsigned int>(mode) << 4) | stride);
+		Filter(mode, stride, input, buffer + 1);
+		output.commit(input.size + 1);
+	}
+
+	ENCODER_METRICS(_metrics.add_bytes(input.size, input.size + 1));
+	ENCODER_METRICS(_metrics.add_symbols(input.size));
+	ENCODER_METRICS(_metrics.set_value("filter_mode", static_cast<double>(mode)));
+	ENCODER_METRICS(_metrics.set_value("filter_stride", stride));
+
+	return true;
+}
+
+// Inverts the filter written in the first byte of the input
+bool DeltaFilter::Decode(ByteView input, ByteSink& output)
+{
+	if (input.size < 1)
+		return false;
+
+	const unsigned int mode = static_cast<unsigned char>(input.data[0]) >> 4;
+	const unsigned int stride = static_cast<unsigned char>(input.data[0]) & 0x0f;
+	if (mode > static_cast<unsigned int>(Mode::Xor) || !ValidStride(stride))
+		return false;
+
+	const ByteView filtered{ input.data + 1, input.size - 1 };
+	if (filtered.size > 0)
+	{
+		ENCODER_METRICS_PHASE(_metrics, EncoderPhase::DecodeLoop);
+		char* buffer = output.reserve(filtered.size);
+		if (buffer == nullptr)
+			return false;
+
+		Unfilter(static_cast<Mode>(mode), stride, filtered, buffer);
+		output.commit(filtered.size);
+	}
+
+	ENCODER_METRICS(_metrics.add_bytes(input.size, filtered.size));
+	ENCODER_METRICS(_metrics.add_symbols(filtered.size));
+
+	return true;
+}
+
+// The filter does not use a key
+bool DeltaFilter::UsesKey() const
+{
+	return false;
+}
+
+// Returns a string identifying the algorithm
+std::string DeltaFilter::Name() const
+{
+	return "Delta filter";
+}
+
+// ---------------------------------------------------------------------------
+// Other public methods
+// ---------------------------------------------------------------------------
+void DeltaFilter::SetFilter(Mode mode, unsigned int stride)
+{
+	assert(stride == 0 || ValidStride(stride));
+	_mode = mode;
+	_stride = stride;
+}
+
+// Tries all filters and word sizes on the start of the input. Filtering which does not lower the entropy is not used.
+void DeltaFilter::ChooseFilter(ByteView input, Mode& mode, unsigned int& stride)
+{
+	const ByteView sample{ input.data, (input.size < sample_size) ? input.size : static_cast<std::size_t>(sample_size) };
+
+	ByteStream filtered;
+	filtered.append(sample.data, sample.size);
+	filtered.bytes_changed();
+
+	mode = Mode::None;
+	stride = 1;
+	double lowest_entropy = filtered.byte_entropy();
+
+	for (Mode candidate_mode : { Mode::Delta, Mode::Xor })
+	{
+		for (unsigned int candidate_stride : { 1, 2, 4, 8 })
+		{
+			Filter(candidate_mode, candidate_stride, sample, filtered.data());
+			filtered.bytes_changed();
+
+			const double entropy = filtered.byte_entropy();
+			if (entropy < lowest_entropy)
+			{
+				lowest_entropy = entropy;
+				mode = candidate_mode;
+				stride = candidate_stride;
+			}
+		}
+	}
+}
+
+// Filters whole words, and copies the bytes after the last whole word
+void DeltaFilter::Filter(Mode mode, unsigned int stride, ByteView input, char* output)
+{
+	assert(ValidStride(stride));
+	const std::size_t words = input.size / stride;
+	const std::size_t filtered = words * stride;
+
+	switch (mode)
+	{
+		case Mode::Delta:
+			switch (stride)
+			{
+				case 1: DeltaWords<std::uint8_t>(input.data, output, words); break;
+				case 2: DeltaWords<std::uint16_t>(input.data, output, words); break;
+				case 4: DeltaWords<std::uint32_t>(input.data, output, words); break;
+				case 8: DeltaWords<std::uint64_t>(input.data, output, words); break;
+			}
+			break;
+
+		// XOR of words is the XOR of their bytes, so this is done on bytes a word apart
+		case Mode::Xor:
+			std::copy(input.data, input.data + std::min<std::size_t>(stride, filtered), output);
+			for (std::size_t i = stride; i < filtered; i++)
+				output[i] = input.data[i] ^ input.data[i - stride];
+			break;
+
+		case Mode::None:
+			std::copy(input.data, input.data + filtered, output);
+			break;
+	}
+
+	std::copy(input.data + filtered, input.data + input.size, output + filtered);
+}
+
+// Inverts Filter()
+void DeltaFilter::Unfilter(Mode mode, unsigned int stride, ByteView input, char* output)
+{
+	assert(ValidStride(stride));
+	const std::size_t words = input.size / stride;
+	const std::size_t filtered = words * stride;
+
+	switch (mode)
+	{
+		case Mode::Delta:
+			switch (stride)
+			{
+				case 1: UndeltaWords<std::uint8_t>(input.data, output, words); break;
+				case 2: UndeltaWords<std::uint16_t>(input.data, output, words); break;
+				case 4: UndeltaWords<std::uint32_t>(input.data, output, words); break;
+				case 8: UndeltaWords<std::uint64_t>(input.data, output, words); break;
+			}
+			break;
+
+		case Mode::Xor:
+			std::copy(input.data, input.data + std::min<std::size_t>(stride, filtered), output);
+			for (std::size_t i = stride; i < filtered; i++)
+				output[i] = input.data[i] ^ output[i - stride];
+			break;
+
+		case Mode::None:
+			std::copy(input.data, input.data + filtered, output);
+			break;
+	}
+
+	std::copy(input.data + filtered, input.data + input.size, output + filtered);
+}
+// ---------------------------------------------------------------------------
@@ -0,0 +1,197 @@
+//////////////////////////////////////////////////////////////////////////////
+// Encoder metrics implementation
+//////////////////////////////////////////////////////////////////////////////
+#include <cassert>
+#include <cmath>
+#include <sstream>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
+
+#include "..\include\EncoderMetrics.h"
+
+// ---------------------------------------------------------------------------
+// Constructor / destructor
+// ---------------------------------------------------------------------------
+// Constructor
+EncoderMetrics::EncoderMetrics() : _phases{}, _bytesIn(0), _bytesOut(0), _symbols(0), _values()
+{
+}
+
+// Destructor
+EncoderMetrics::~EncoderMetrics()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Collection methods
+// ---------------------------------------------------------------------------
+// Adds time spent in a phase
+void EncoderMetrics::add_phase(EncoderPhase phase, double wallSeconds, double cpuSeconds)
+{
+	assert(phase != EncoderPhase::Count);
+
+	PhaseTiming& timing = _phases[static_cast<int>(phase)];
+	timing.wallSeconds += wallSeconds;
+	timing.cpuSeconds += cpuSeconds;
+	++timing.calls;
+}
+
+// Adds the number of bytes read and written
+void EncoderMetrics::add_bytes(unsigned long long bytesIn, unsigned long long bytesOut)
+{
+	_bytesIn += bytesIn;
+	_bytesOut += bytesOut;
+}
+
+// Adds the number of symbols (bytes) encoded or decoded
+void EncoderMetrics::add_symbols(unsigned long long symbols)
+{
+	_symbols += symbols;
+}
+
+// Sets an algorithm specific value
+void EncoderMetrics::set_value(const std::string& name, double value)
+{
+	_values[name] = value;
+}
+
+// Resets all metrics
+void EncoderMetrics::clear()
+{
+	*this = EncoderMetrics();
+}
+
+// ---------------------------------------------------------------------------
+// Access methods
+// ---------------------------------------------------------------------------
+double EncoderMetrics::wall_seconds(EncoderPhase phase) const
+{
+	assert(phase != EncoderPhase::Count);
+	return _phases[static_cast<int>(phase)].wallSeconds;
+}
+
+double EncoderMetrics::cpu_seconds(EncoderPhase phase) const
+{
+	assert(phase != EncoderPhase::Count);
+	return _phases[static_cast<int>(phase)].cpuSeconds;
+}
+
+unsigned long long EncoderMetrics::bytes_in() const
+{
+	return _bytesIn;
+}
+
+unsigned long long EncoderMetrics::bytes_out() const
+{
+	return _bytesOut;
+}
+
+unsigned long long EncoderMetrics::symbols() const
+{
+	return _symbols;
+}
+
+// Returns the number of symbols coded per second spent in the encoding and decoding loops
+double EncoderMetrics::symbols_per_second() const
+{
+	const double seconds = wall_seconds(EncoderPhase::EncodeLoop) + wall_seconds(EncoderPhase::DecodeLoop);
+	return (seconds > 0) ? static_cast<double>(_symbols) / seconds : 0;
+}
+
+// Returns an algorithm specific value, or zero if it has not been set
+double EncoderMetrics::value(const std::string& name) const
+{
+	auto i = _values.find(name);
+	return (i != _values.cend()) ? i->second : 0;
+}
+
+// Exports the metrics as a JSON object
+std::string EncoderMetrics::to_json() const
+{
+	const char* phase_names[] = { "key_build", "encode_loop", "decode_loop", "stats_update" };
+	static_assert(sizeof(phase_names) / sizeof(phase_names[0]) == static_cast<int>(EncoderPhase::Count), "Missing phase name");
+
+	// JSON has no representation of infinity or NaN
+	auto number = [](double value) -> std::string
+	{
+		if (!std::isfinite(value))
+			return "null";
+
+		std::ostringstream stream;
+		stream.precision(12);
+		stream << value;
+		return stream.str();
+	};
+
+	std::ostringstream json;
+	json << "{\"phases\":{";
+	for (int i = 0; i < static_cast<int>(EncoderPhase::Count); i++)
+	{
+		json << (i > 0 ? "," : "") << "\"" << phase_names[i] << "\":{";
+		json << "\"wall_seconds\":" << number(_phases[i].wallSeconds) << ",";
+		json << "\"cpu_seconds\":" << number(_phases[i].cpuSeconds) << ",";
+		json << "\"calls\":" << _phases[i].calls << "}";
+	}
+	json << "},";
+	json << "\"bytes_in\":" << _bytesIn << ",";
+	json << "\"bytes_out\":" << _bytesOut << ",";
+	json << "\"symbols\":" << _symbols << ",";
+	json << "\"symbols_per_second\":" << number(symbols_per_second()) << ",";
+
+	// Value names are identifiers set by the encoders, so they need no escaping
+	json << "\"values\":{";
+	for (auto i = _values.cbegin(); i != _values.cend(); i++)
+		json << (i != _values.cbegin() ? "," : "") << "\"" << i->first << "\":" << number(i->second);
+	json << "}}";
+
+	return json.str();
+}
+
+// ---------------------------------------------------------------------------
+// Scoped phase timer
+// ---------------------------------------------------------------------------
+// Starts timing a phase
+// NOTE: The CPU time is that of the thread timing the phase, threads started within the phase are not included.
+ScopedPhaseTimer::ScopedPhaseTimer(EncoderMetrics& metrics, EncoderPhase phase)
+	:	_metrics(metrics),
+		_phase(phase),
+		_wallStart(std::chrono::steady_clock::now()),
+		_cpuStart(ThreadCpuSeconds())
+{
+}
+
+// Adds the elapsed time to the phase
+ScopedPhaseTimer::~ScopedPhaseTimer()
+{
+	const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - _wallStart;
+	const double cpu = ThreadCpuSeconds() - _cpuStart;
+	_metrics.add_phase(_phase, wall.count(), cpu);
+}
+
+// std::clock() cannot be used, as it measures wall time on Windows and the time of all threads elsewhere
+double ScopedPhaseTimer::ThreadCpuSeconds()
+{
+#ifdef _WIN32
+	FILETIME creation_time, exit_time, kernel_time, user_time;
+	if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time))
+		return 0;
+
+	// The times are counted in 100 ns units
+	const unsigned long long kernel = (static_cast<unsigned long long>(kernel_time.dwHighDateTime) << 32) | kernel_time.dwLowDateTime;
+	const unsigned long long user = (static_cast<unsigned long long>(user_time.dwHighDateTime) << 32) | user_time.dwLowDateTime;
+	return static_cast<double>(kernel + user) * 1e-7;
+#else
+	timespec time;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+		return 0;
+
+	return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+#endif
+}
+// ---------------------------------------------------------------------------
@@ -0,0 +1,604 @@
+//////////////////////////////////////////////////////////////////////////////
+// Encoder verifier implementation
+//////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+#include "..\include\EncoderVerifier.h"
+#include "..\include\CodecCache.h"
+#include "..\include\DeltaFilter.h"
+#include "..\include\FilePipeline.h"
+#include "..\include\SeekIndex.h"
+#include "..\include\SimpleCodec.h"
+#include "..\include\SimpleCompression.h"
+
+// ---------------------------------------------------------------------------
+// Constructor / destructor
+// ---------------------------------------------------------------------------
+// Constructor
+EncoderVerifier::EncoderVerifier(unsigned int seed) : _random(seed), _checks(0), _failures()
+{
+}
+
+// Destructor
+EncoderVerifier::~EncoderVerifier()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Private methods
+// ---------------------------------------------------------------------------
+// Counts a check, and records it if it failed
+bool EncoderVerifier::Check(bool passed, const std::string& check, std::size_t size)
+{
+	++_checks;
+	if (!passed)
+		_failures.push_back(check + " (" + std::to_string(size) + " bytes)");
+
+	return passed;
+}
+
+// Generates inputs for the checks
+std::vector<std::vector<char>> EncoderVerifier::GenerateInputs(int iterations)
+{
+	std::vector<std::vector<char>> inputs;
+
+	// A single byte, and runs of a single byte value (keys with a single codeword)
+	inputs.push_back(std::vector<char>(1, 'a'));
+	for (std::size_t size : { 2, 7, 8, 9, 1000 })
+		inputs.push_back(std::vector<char>(size, static_cast<char>(0xFF)));
+
+	// All 256 byte values, once in order and repeatedly in random order
+	std::vector<char> all_bytes(256);
+	for (int i = 0; i < 256; i++)
+		all_bytes[i] = static_cast<char>(i);
+	inputs.push_back(all_bytes);
+
+	std::vector<char> shuffled;
+	for (int i = 0; i < 20; i++)
+	{
+		std::shuffle(all_bytes.begin(), all_bytes.end(), _random);
+		shuffled.insert(shuffled.end(), all_bytes.cbegin(), all_bytes.cend());
+	}
+	inputs.push_back(shuffled);
+
+	// Random alphabets with skewed frequencies, such that the keys get codewords of all lengths,
+	// and random sizes, such that the encodings end at all bit positions
+	for (int i = 0; i < iterations; i++)
+	{
+		std::shuffle(all_bytes.begin(), all_bytes.end(), _random);
+		const int alphabet_size = 1 + static_cast<int>(_random() % 256);
+		const std::size_t size = 1 + ((i % 10 == 0) ? _random() % 100000 : _random() % 2000);
+		std::geometric_distribution<int> skew(0.02 + 0.9 * std::uniform_real_distribution<double>()(_random));
+
+		std::vector<char> input(size);
+		for (auto j = input.begin(); j != input.end(); j++)
+			*j = all_bytes[std::min(skew(_random), alphabet_size - 1)];
+		inputs.push_back(input);
+	}
+
+	// Slowly changing little-endian numbers of 2, 4 and 8 bytes, with a few bytes after the last whole number
+	for (int bytes : { 2, 4, 8 })
+	{
+		std::vector<char> input;
+		unsigned long long value = _random();
+		for (int i = 0; i < 3000; i++)
+		{
+			value += _random() % 64;
+			for (int b = 0; b < bytes; b++)
+				input.push_back(static_cast<char>(value >> (8 * b)));
+		}
+		input.resize(input.size() + _random() % bytes);
+		inputs.push_back(input);
+	}
+
+	return inputs;
+}
+
+// ---------------------------------------------------------------------------
+// Reference implementation
+// ---------------------------------------------------------------------------
+// Reads the codewords of a key one at a time
+bool EncoderVerifier::ReferenceKey(const ByteStream& keyStream, reference_map& map, int& bits_short, int& bits_long)
+{
+	if (keyStream.size() < 6)
+		return false;
+
+	const int map_size = (static_cast<unsigned char>(keyStream[0]) << 8) | static_cast<unsigned char>(keyStream[1]);
+	const int short_words_count = (static_cast<unsigned char>(keyStream[2]) << 8) | static_cast<unsigned char>(keyStream[3]);
+	bits_short = static_cast<unsigned char>(keyStream[4]);
+	bits_long = static_cast<unsigned char>(keyStream[5]);
+
+	if (bits_short < 1 || bits_short > 8 || (bits_long != 0 && (bits_long <= bits_short || bits_long > bits_short + 8)))
+		return false;
+	if (map_size > 256 || short_words_count > map_size || (bits_long == 0 && short_words_count < map_size))
+		return false;
+	if (static_cast<bitstream_index>(keyStream.size()) * 8 < 48 + short_words_count * (8 + bits_short) + (map_size - short_words_count) * (8 + bits_long))
+		return false;
+
+	bitstream_index bit_ptr = 48;
+	for (int i = 0; i < map_size; i++)
+	{
+		const int bits = (i < short_words_count) ? bits_short : bits_long;
+		const char key = keyStream.read(bit_ptr, 8);
+		bit_ptr += 8;
+
+		unsigned int codeword = 0;
+		for (int j = 0; j < bits; j++)
+			codeword = (codeword << 1) | (static_cast<unsigned int>(keyStream.read(bit_ptr++, 1)) & 1);
+
+		map[key] = std::make_pair(codeword, bits);
+	}
+
+	return true;
+}
+
+// Puts the codeword of each byte into the output, returns false if a byte has no codeword
+bool EncoderVerifier::ReferenceEncode(const reference_map& map, ByteView input, ByteStream& output)
+{
+	output.clear();
+
+	for (std::size_t i = 0; i < input.size; i++)
+	{
+		auto symbol = map.find(input.data[i]);
+		if (symbol == map.cend())
+			return false;
+
+		const unsigned int codeword = symbol->second.first;
+		const int bits = symbol->second.second;
+		if (bits > 8)
+		{
+			output.put(static_cast<char>((codeword >> 8) & 0xFF), static_cast<unsigned short>(bits - 8));
+			output.put(static_cast<char>(codeword & 0xFF), 8);
+		}
+		else
+		{
+			output.put(static_cast<char>(codeword & 0xFF), static_cast<unsigned short>(bits));
+		}
+	}
+
+	return true;
+}
+
+// Reads the codewords one at a time, while a codeword ends before the last bit of the input.
+// Codewords which are not in the key are decoded as zero bytes.
+void EncoderVerifier::ReferenceDecode(const reference_map& map, int bits_short, int bits_long, const ByteStream& input, std::vector<char>& output)
+{
+	std::map<std::pair<unsigned int, int>, char> decoder;
+	for (auto i = map.cbegin(); i != map.cend(); i++)
+		decoder[i->second] = i->first;
+
+	const unsigned int extended_bitset_key = (1u << bits_short) - 1;
+	const bitstream_index total_bits = static_cast<bitstream_index>(input.size()) * 8;
+
+	output.clear();
+	bitstream_index bit_ptr = 0;
+	while (bit_ptr + bits_short < total_bits)
+	{
+		unsigned int codeword = static_cast<unsigned int>(input.read(bit_ptr, static_cast<unsigned short>(bits_short))) & 0xFF;
+		bit_ptr += bits_short;
+		int bits = bits_short;
+
+		if (codeword == extended_bitset_key && bits_long != 0)
+		{
+			if (bit_ptr + (bits_long - bits_short) >= total_bits)
+				break;
+
+			for (int j = bits_short; j < bits_long; j++)
+				codeword = (codeword << 1) | (static_cast<unsigned int>(input.read(bit_ptr++, 1)) & 1);
+			bits = bits_long;
+		}
+
+		auto symbol = decoder.find(std::make_pair(codeword, bits));
+		output.push_back((symbol != decoder.cend()) ? symbol->second : 0);
+	}
+}
+
+// Counts each byte with its exact context of up to two preceding bytes (zero before the input), and computes the entropy
+double EncoderVerifier::ReferenceConditionalEntropy(ByteView input, int order)
+{
+	std::map<unsigned int, std::map<char, unsigned long long>> counts;
+	unsigned int context = 0;
+	for (std::size_t i = 0; i < input.size; i++)
+	{
+		++counts[context][input.data[i]];
+		context = ((context << 8) | static_cast<unsigned char>(input.data[i])) & ((order == 1) ? 0xFFu : 0xFFFFu);
+	}
+
+	double entropy = 0;
+	for (auto i = counts.cbegin(); i != counts.cend(); i++)
+	{
+		unsigned long long context_total = 0;
+		for (auto j = i->second.cbegin(); j != i->second.cend(); j++)
+			context_total += j->second;
+
+		for (auto j = i->second.cbegin(); j != i->second.cend(); j++)
+			entropy -= static_cast<double>(j->second) * std::log2(static_cast<double>(j->second) / static_cast<double>(context_total));
+	}
+
+	return (input.size > 0) ? entropy / static_cast<double>(input.size) : 0;
+}
+
+// ---------------------------------------------------------------------------
+// Checks
+// ---------------------------------------------------------------------------
+// Round-trips the input through the view interface of an encoder
+bool EncoderVerifier::CheckRoundTrip(ByteStreamEncoder& encoder, ByteView input)
+{
+	std::vector<char> encoded;
+	VectorSink encoded_sink(encoded);
+	if (!Check(encoder.Encode(input, encoded_sink), encoder.Name() + ": encode", input.size))
+		return false;
+
+	std::vector<char> decoded;
+	VectorSink decoded_sink(decoded);
+	const bool decoded_ok = encoder.Decode(ByteView{ encoded.data(), encoded.size() }, decoded_sink);
+
+	return Check(decoded_ok && decoded.size() == input.size && std::equal(decoded.cbegin(), decoded.cend(), input.data), encoder.Name() + ": round-trip", input.size);
+}
+
+// Compares the generic and specialized loops of a valid key, and all ways of coding with them, against the reference
+bool EncoderVerifier::CheckCodec(const ByteStream& keyStream, ByteView input)
+{
+	const std::size_t failures = _failures.size();
+
+	reference_map map;
+	int bits_short;
+	int bits_long;
+	const bool valid = ReferenceKey(keyStream, map, bits_short, bits_long);
+
+	const std::shared_ptr<const SimpleCodec> codecs[] = { SimpleCodec::Compile(keyStream, false), SimpleCodec::Compile(keyStream, true) };
+	if (!Check(valid == static_cast<bool>(codecs[0]) && valid == static_cast<bool>(codecs[1]), "codec: key validation", keyStream.size()) || !valid)
+		return _failures.size() == failures;
+
+	ByteStream reference;
+	const bool encodable = ReferenceEncode(map, input, reference);
+	std::vector<char> reference_decoded;
+	ReferenceDecode(map, bits_short, bits_long, reference, reference_decoded);
+
+	for (auto i = std::begin(codecs); i != std::end(codecs); i++)
+	{
+		const SimpleCodec& codec = **i;
+		const std::string name = codec.specialized() ? "specialized codec: " : "generic codec: ";
+
+		// Encoding of the whole input
+		std::vector<char> encoded;
+		if (!Check(codec.Encode(input, encoded) == encodable, name + "encode result", input.size) || !encodable)
+			continue;
+		Check(encoded.size() == reference.size() && std::equal(encoded.cbegin(), encoded.cend(), reference.data()), name + "encode", input.size);
+		const ByteView encoded_view{ encoded.data(), encoded.size() };
+
+		// Decoding of exactly the input size, and until the end of the encoding
+		std::vector<char> decoded;
+		codec.Decode(encoded_view, decoded, input.size);
+		Check(decoded.size() == input.size && std::equal(decoded.cbegin(), decoded.cend(), input.data), name + "decode", input.size);
+
+		decoded.clear();
+		codec.Decode(encoded_view, decoded);
+		Check(decoded == reference_decoded, name + "decode without size", input.size);
+
+		// Encoding in random parts, into a buffer of the documented size, while building an index
+		SeekIndex index(1 + _random() % 100);
+		SimpleCodec::encoding_state state{};
+		std::vector<char> buffer(codec.MaxEncodedSize(input.size));
+		SpanSink buffer_sink(buffer.data(), buffer.size());
+		bool parts_ok = true;
+		for (std::size_t position = 0; position < input.size || position == 0;)
+		{
+			const std::size_t part = std::min<std::size_t>(input.size - position, _random() % 300);
+			const bool final = (position + part == input.size);
+			parts_ok &= codec.Encode(ByteView{ input.data + position, part }, buffer_sink, state, final, &index);
+			position += part;
+			if (final)
+				break;
+		}
+		Check(parts_ok && buffer_sink.written() == encoded.size() && std::equal(encoded.cbegin(), encoded.cend(), buffer.cbegin()), name + "encode in parts", input.size);
+
+		// Decoding of random ranges with the index
+		Check(index.symbols() == input.size && index.blocks() == (input.size + index.block_size() - 1) / index.block_size(), name + "seek index", input.size);
+		for (int j = 0; j < 8; j++)
+		{
+			const std::size_t offset = _random() % (input.size + 1);
+			const std::size_t length = _random() % (input.size - offset + 1);
+
+			std::vector<char> range;
+			VectorSink range_sink(range);
+			const bool range_ok = codec.DecodeRange(encoded_view, index, offset, length, range_sink);
+			Check(range_ok && range.size() == length && std::equal(range.cbegin(), range.cend(), input.data + offset), name + "decode range", input.size);
+		}
+		Check(!codec.DecodeRange(encoded_view, index, input.size, 1, buffer_sink), name + "decode range beyond the end", input.size);
+
+		// Encoding and decoding of random messages in a batch
+		std::vector<ByteView> messages;
+		std::vector<std::size_t> sizes;
+		for (std::size_t position = 0; position < input.size;)
+		{
+			sizes.push_back(std::min<std::size_t>(input.size - position, _random() % 200));
+			messages.push_back(ByteView{ input.data + position, sizes.back() });
+			position += sizes.back();
+		}
+
+		std::vector<char> arena;
+		std::vector<std::size_t> offsets;
+		codec.EncodeBatch(messages, arena, offsets);
+
+		std::vector<ByteView> encoded_messages;
+		for (std::size_t j = 0; j < messages.size(); j++)
+			encoded_messages.push_back(ByteView{ arena.data() + offsets[j], offsets[j + 1] - offsets[j] });
+
+		std::vector<char> decoded_arena;
+		const bool batch_decoded = codec.DecodeBatch(encoded_messages, sizes, decoded_arena, offsets);
+		Check(batch_decoded && decoded_arena.size() == input.size && std::equal(decoded_arena.cbegin(), decoded_arena.cend(), input.data), name + "batch", input.size);
+	}
+
+	return _failures.size() == failures;
+}
+
+// Decodes arbitrary bytes with the generic and specialized loops, and compares them against the reference
+bool EncoderVerifier::CheckDecode(const ByteStream& keyStream, ByteView input)
+{
+	const std::size_t failures = _failures.size();
+
+	reference_map map;
+	int bits_short;
+	int bits_long;
+	const bool valid = ReferenceKey(keyStream, map, bits_short, bits_long);
+
+	const std::shared_ptr<const SimpleCodec> codecs[] = { SimpleCodec::Compile(keyStream, false), SimpleCodec::Compile(keyStream, true) };
+	if (!Check(valid == static_cast<bool>(codecs[0]) && valid == static_cast<bool>(codecs[1]), "codec: key validation", keyStream.size()) || !valid)
+		return _failures.size() == failures;
+
+	ByteStream input_stream;
+	input_stream.append(input.data, input.size);
+	std::vector<char> reference_decoded;
+	ReferenceDecode(map, bits_short, bits_long, input_stream, reference_decoded);
+
+	for (auto i = std::begin(codecs); i != std::end(codecs); i++)
+	{
+		const SimpleCodec& codec = **i;
+		const std::string name = codec.specialized() ? "specialized codec: " : "generic codec: ";
+
+		std::vector<char> decoded;
+		codec.Decode(input, decoded);
+		Check(decoded == reference_decoded, name + "decode of random bytes", input.size);
+
+		// A limited decoding stops within the decoded bytes
+		const std::size_t limit = _random() % (reference_decoded.size() + 1);
+		decoded.clear();
+		codec.Decode(input, decoded, limit);
+		Check(decoded.size() == limit && std::equal(decoded.cbegin(), decoded.cend(), reference_decoded.cbegin()), name + "limited decode of random bytes", input.size);
+	}
+
+	return _failures.size() == failures;
+}
+
+// The order-1 context is exact. The hashed order-2 context splits the order-1 contexts, so its entropy is at most
+// that of order 1, and at least that of the exact order-2 context.
+bool EncoderVerifier::CheckStatistics(ByteView input)
+{
+	const std::size_t failures = _failures.size();
+	const double tolerance = 1e-9;
+
+	ByteStream stream;
+	stream.append(input.data, input.size);
+	stream.set_context_order(2);
+	stream.bytes_changed();
+
+	const double order1 = stream.conditional_entropy(1);
+	const double order2 = stream.conditional_entropy(2);
+	Check(std::fabs(order1 - ReferenceConditionalEntropy(input, 1)) <= tolerance, "byte stream: order-1 entropy", input.size);
+	Check(order2 <= order1 + tolerance && order2 >= ReferenceConditionalEntropy(input, 2) - tolerance, "byte stream: order-2 entropy", input.size);
+
+	return _failures.size() == failures;
+}
+
+// Runs the checks on generated inputs, with keys generated for the inputs, keys of other inputs and random keys
+bool EncoderVerifier::Run(int iterations)
+{
+	const std::size_t failures = _failures.size();
+
+	ByteStream previous_key;
+	ByteView previous_input{ nullptr, 0 };
+	CodecCache cache(4);
+	const std::vector<std::vector<char>> inputs = GenerateInputs(iterations);
+	for (auto i = inputs.cbegin(); i != inputs.cend(); i++)
+	{
+		const ByteView input{ i->data(), i->size() };
+
+		ByteStream in_stream;
+		ByteStream out_stream;
+		ByteStream key_stream;
+		in_stream.append(input.data, input.size);
+		in_stream.bytes_changed();
+
+		CheckStatistics(input);
+
+		for (double fraction : { 0.5, 0.8, 0.95, 0.999 })
+		{
+			SimpleCompression compression(in_stream, out_stream, key_stream);
+			compression.SetTargetFraction(fraction);
+			if (!Check(compression.GenerateKey(), compression.Name() + ": generate key", input.size))
+				continue;
+
+			// The seek index gives the exact size to decode
+			SeekIndex index;
+			compression.SetSeekIndex(&index);
+			CheckRoundTrip(compression, input);
+
+			CheckCodec(key_stream, input);
+
+			// Random bytes are decoded as if they were an encoding
+			std::vector<char> noise(_random() % (2 * input.size + 16));
+			for (auto j = noise.begin(); j != noise.end(); j++)
+				*j = static_cast<char>(_random());
+			CheckDecode(key_stream, ByteView{ noise.data(), noise.size() });
+		}
+
+		// The delta filter with the filter chosen from the input, and with each filter and word size
+		DeltaFilter filter(in_stream, out_stream, key_stream);
+		CheckRoundTrip(filter, input);
+		for (DeltaFilter::Mode mode : { DeltaFilter::Mode::None, DeltaFilter::Mode::Delta, DeltaFilter::Mode::Xor })
+		{
+			for (unsigned int stride : { 1, 2, 4, 8 })
+			{
+				filter.SetFilter(mode, stride);
+				CheckRoundTrip(filter, input);
+			}
+		}
+
+		// The key of another input may lack codewords for some of the bytes
+		if (previous_key.size() > 0)
+			CheckCodec(previous_key, input);
+		previous_key = key_stream;
+
+		// A key trained on samples can encode any input. With the key id embedded in the encoding,
+		// an encoder without the key decodes it with the codec of the id in the cache.
+		ByteStream trained_key;
+		SeekIndex trained_index;
+		SimpleCompression trained(in_stream, out_stream, trained_key);
+		trained.SetCodecCache(&cache);
+		trained.SetEmbedKeyId(true);
+		trained.SetSeekIndex(&trained_index);
+		trained.SetTargetFraction((i - inputs.cbegin()) % 2 == 0 ? 0.8 : 0.999);
+		if (Check(trained.TrainKey({ previous_input, input }), trained.Name() + ": train key", input.size))
+		{
+			CheckRoundTrip(trained, input);
+			Check(cache.Get(trained_key) == cache.Get(trained_key) && cache.size() <= cache.capacity(), "codec cache: lookup", input.size);
+
+			std::vector<char> encoded;
+			VectorSink encoded_sink(encoded);
+			trained.Encode(input, encoded_sink);
+
+			ByteStream no_key;
+			SimpleCompression decoder(in_stream, out_stream, no_key);
+			decoder.SetCodecCache(&cache);
+			decoder.SetEmbedKeyId(true);
+			decoder.SetSeekIndex(&trained_index);
+
+			std::vector<char> decoded;
+			VectorSink decoded_sink(decoded);
+			const bool decoded_ok = decoder.Decode(ByteView{ encoded.data(), encoded.size() }, decoded_sink);
+			Check(decoded_ok && decoded.size() == input.size && std::equal(decoded.cbegin(), decoded.cend(), input.data), decoder.Name() + ": decode with embedded key id", input.size);
+		}
+		previous_input = input;
+
+		// Random keys, which need not be prefix-free and are sometimes truncated, must be rejected or decode like the reference
+		const int bits_short = 1 + static_cast<int>(_random() % 8);
+		const int bits_long = (_random() % 2 == 0) ? 0 : bits_short + 1 + static_cast<int>(_random() % 8);
+		const int map_size = static_cast<int>(_random() % 257);
+		const int short_words_count = (bits_long != 0) ? static_cast<int>(_random() % (map_size + 1)) : map_size;
+		const int key_bits = 48 + short_words_count * (8 + bits_short) + (map_size - short_words_count) * (8 + bits_long);
+
+		// Keys with codewords are sometimes cut within the codewords, the six header bytes are always written
+		const bool truncated = map_size > 0 && _random() % 4 == 0;
+		std::vector<char> random_key_bytes((key_bits + 7) / 8 - (truncated ? 1 : 0));
+		for (auto j = random_key_bytes.begin(); j != random_key_bytes.end(); j++)
+			*j = static_cast<char>(_random());
+		random_key_bytes[0] = static_cast<char>(map_size >> 8);
+		random_key_bytes[1] = static_cast<char>(map_size);
+		random_key_bytes[2] = static_cast<char>(short_words_count >> 8);
+		random_key_bytes[3] = static_cast<char>(short_words_count);
+		random_key_bytes[4] = static_cast<char>(bits_short);
+		random_key_bytes[5] = static_cast<char>(bits_long);
+
+		ByteStream random_key;
+		random_key.append(random_key_bytes.data(), random_key_bytes.size());
+		CheckDecode(random_key, input);
+	}
+
+	return _failures.size() == failures;
+}
+
+// Writes a sparse file of zero bytes with a few marker strings, at the start, straddling the first 4 GiB and at the end.
+// The file is loaded and analysed, then encoded from disk by a file pipeline (so that only the input is held
+// in memory at any time), and the markers are decoded from the encoding using the seek index.
+bool EncoderVerifier::CheckLargeInput(const std::string& filename, unsigned long long size)
+{
+	const std::size_t failures = _failures.size();
+	const std::string marker = "ByteStream";
+	const std::string encoded_filename = filename + ".encoded";
+	assert(size >= 4 * marker.size());
+
+	const unsigned long long boundary = 1ULL << 32;
+	const unsigned long long middle = (size > boundary + marker.size()) ? boundary - marker.size() / 2 : size / 2;
+	const unsigned long long offsets[] = { 0, middle, size - marker.size() };
+
+	// Only the blocks with markers are written, the rest of the file is left as a hole
+	{
+		std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		for (unsigned long long offset : offsets)
+		{
+			file.seekp(static_cast<std::streamoff>(offset));
+			file.write(marker.data(), static_cast<std::streamsize>(marker.size()));
+		}
+		if (!Check(file.good(), "large input: write " + filename, static_cast<std::size_t>(size)))
+			return false;
+	}
+
+	// Load the file, and check the sizes and counts above 32 bits
+	ByteStream key_stream;
+	{
+		ByteStream input;
+		ByteStream output;
+		if (!Check(input.load(filename) && input.size() == size, "large input: load", static_cast<std::size_t>(size)))
+		{
+			std::remove(filename.c_str());
+			return false;
+		}
+		input.bytes_changed();
+
+		unsigned long long total = 0;
+		for (int i = 0; i < 256; i++)
+			total += input.byte_frequency(i);
+		Check(total == size && input.byte_frequency(0) == size - 3 * marker.size(), "large input: byte frequencies", static_cast<std::size_t>(size));
+
+		SimpleCompression compression(input, output, key_stream);
+		Check(compression.GenerateKey(), "large input: generate key", static_cast<std::size_t>(size));
+	}
+
+	// Encode the file, building its seek index
+	SeekIndex index;
+	std::shared_ptr<const SimpleCodec> codec = SimpleCodec::Compile(key_stream);
+	if (codec)
+	{
+		FilePipeline pipeline(codec);
+		if (Check(pipeline.EncodeFile(filename, encoded_filename, &index) && index.symbols() == size, "large input: encode", static_cast<std::size_t>(size)))
+		{
+			// Decode the markers, each starting its own range
+			ByteStream encoded;
+			ByteStream decoded;
+			if (Check(encoded.load(encoded_filename), "large input: load encoding", static_cast<std::size_t>(size)))
+			{
+				SimpleCompression compression(encoded, decoded, key_stream);
+				compression.SetSeekIndex(&index);
+				for (unsigned long long offset : offsets)
+				{
+					const bool decoded_ok = compression.DecodeRange(offset, marker.size());
+					Check(decoded_ok && std::string(decoded.data(), decoded.size()) == marker, "large input: decode range at " + std::to_string(offset), static_cast<std::size_t>(size));
+				}
+			}
+		}
+	}
+
+	std::remove(filename.c_str());
+	std::remove(encoded_filename.c_str());
+
+	return _failures.size() == failures;
+}
+
+// ---------------------------------------------------------------------------
+// Results
+// ---------------------------------------------------------------------------
+unsigned long long EncoderVerifier::Checks() const
+{
+	return _checks;
+}
+
+const std::vector<std::string>& EncoderVerifier::Failures() const
+{
+	return _failures;
+}
+// ---------------------------------------------------------------------------
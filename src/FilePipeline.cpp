@@ -0,0 +1,209 @@
+//////////////////////////////////////////////////////////////////////////////
+// File pipeline implementation
+//////////////////////////////////////////////////////////////////////////////
+#include <cassert>
+#include <fstream>
+#include <thread>
+
+#include "..\include\FilePipeline.h"
+
+// ---------------------------------------------------------------------------
+// Buffer queue
+// ---------------------------------------------------------------------------
+// Constructor
+FilePipeline::BufferQueue::BufferQueue() : _buffers(), _closed(false), _mutex(), _condition()
+{
+}
+
+// Hands a buffer to the next stage
+void FilePipeline::BufferQueue::push(int buffer)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_buffers.push_back(buffer);
+	}
+	_condition.notify_one();
+}
+
+// Waits for a buffer. Once the queue is closed, the remaining buffers are returned before failing.
+bool FilePipeline::BufferQueue::pop(int& buffer)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_condition.wait(lock, [this]() { return !_buffers.empty() || _closed; });
+
+	if (_buffers.empty())
+		return false;
+
+	buffer = _buffers.front();
+	_buffers.pop_front();
+	return true;
+}
+
+// Signals that no more buffers will be pushed (or that the pipeline is stopping)
+void FilePipeline::BufferQueue::close()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_closed = true;
+	}
+	_condition.notify_all();
+}
+
+// ---------------------------------------------------------------------------
+// Constructor / destructor
+// ---------------------------------------------------------------------------
+// Constructor
+FilePipeline::FilePipeline(std::shared_ptr<const SimpleCodec> codec, std::size_t chunkSize) : _codec(codec), _chunkSize(chunkSize), _metrics()
+{
+	assert(_codec);
+	assert(_chunkSize > 0);
+}
+
+// Destructor
+FilePipeline::~FilePipeline()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Public interface
+// ---------------------------------------------------------------------------
+// Encodes a file chunk by chunk, overlapping the reading, encoding and writing of consecutive chunks
+bool FilePipeline::EncodeFile(const std::string& inFile, const std::string& outFile, SeekIndex* index)
+{
+	std::ifstream inHandle(inFile.c_str(), std::ios::in | std::ios::binary);
+	if (!inHandle.good() || !inHandle.is_open())
+		return false;
+
+	std::ofstream outHandle(outFile.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!outHandle.good() || !outHandle.is_open())
+		return false;
+
+	// Fixed size buffers, allocated once. Output buffers also have room for the bits carried between chunks.
+	const std::size_t out_capacity = _codec->MaxEncodedSize(_chunkSize);
+	std::vector<char> in_buffers[buffer_count];
+	std::vector<char> out_buffers[buffer_count];
+	std::size_t in_sizes[buffer_count] = {};
+	std::size_t out_sizes[buffer_count] = {};
+
+	// Empty buffers go back to the stage filling them
+	BufferQueue free_input, full_input, free_output, full_output;
+	for (int i = 0; i < buffer_count; i++)
+	{
+		in_buffers[i].resize(_chunkSize);
+		out_buffers[i].resize(out_capacity);
+		free_input.push(i);
+		free_output.push(i);
+	}
+
+	// Reader thread, reading ahead while the previous chunks are encoded
+	bool read_failed = false;
+	std::thread reader([&]()
+	{
+		int buffer;
+		while (free_input.pop(buffer))
+		{
+			inHandle.read(in_buffers[buffer].data(), static_cast<std::streamsize>(_chunkSize));
+			in_sizes[buffer] = static_cast<std::size_t>(inHandle.gcount());
+
+			if (inHandle.bad())
+			{
+				read_failed = true;
+				break;
+			}
+
+			if (in_sizes[buffer] > 0)
+				full_input.push(buffer);
+
+			if (inHandle.eof())
+				break;
+		}
+
+		full_input.close();
+	});
+
+	// Writer thread, writing the previous chunks while the next ones are encoded
+	bool write_failed = false;
+	std::thread writer([&]()
+	{
+		int buffer;
+		while (full_output.pop(buffer))
+		{
+			outHandle.write(out_buffers[buffer].data(), static_cast<std::streamsize>(out_sizes[buffer]));
+			if (!outHandle.good())
+			{
+				write_failed = true;
+				break;
+			}
+
+			free_output.push(buffer);
+		}
+
+		// Stop the encoding if the writer failed
+		free_output.close();
+	});
+
+	// Encode the chunks as parts of one message, padding the last byte after the final chunk
+	if (index != nullptr)
+		index->clear();
+	SimpleCodec::encoding_state state{};
+	unsigned long long bytes_in = 0;
+	unsigned long long bytes_out = 0;
+	bool encode_failed = false;
+	bool input_left = true;
+	while (input_left)
+	{
+		int in_buffer = -1;
+		input_left = full_input.pop(in_buffer);
+
+		int out_buffer;
+		if (!free_output.pop(out_buffer))
+		{
+			encode_failed = true;
+			break;
+		}
+
+		SpanSink sink(out_buffers[out_buffer].data(), out_capacity);
+		{
+			ENCODER_METRICS_PHASE(_metrics, EncoderPhase::EncodeLoop);
+			ByteView input = input_left ? ByteView{ in_buffers[in_buffer].data(), in_sizes[in_buffer] } : ByteView{ nullptr, 0 };
+			encode_failed = !_codec->Encode(input, sink, state, !input_left, index);
+		}
+		out_sizes[out_buffer] = sink.written();
+		full_output.push(out_buffer);
+
+		if (input_left)
+		{
+			bytes_in += in_sizes[in_buffer];
+			free_input.push(in_buffer);
+		}
+		bytes_out += sink.written();
+
+		if (encode_failed)
+			break;
+	}
+
+	// Let the threads finish (the reader may be waiting for a buffer if the encoding stopped early)
+	free_input.close();
+	full_output.close();
+	reader.join();
+	writer.join();
+
+	ENCODER_METRICS(_metrics.add_bytes(bytes_in, bytes_out));
+	ENCODER_METRICS(_metrics.add_symbols(bytes_in));
+
+	return !read_failed && !write_failed && !encode_failed;
+}
+
+// ---------------------------------------------------------------------------
+// Access methods
+// ---------------------------------------------------------------------------
+const EncoderMetrics& FilePipeline::Metrics() const
+{
+	return _metrics;
+}
+
+void FilePipeline::ResetMetrics()
+{
+	_metrics.clear();
+}
+// ---------------------------------------------------------------------------
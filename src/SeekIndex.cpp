@@ -0,0 +1,141 @@
+//////////////////////////////////////////////////////////////////////////////
+// Seek index implementation
+//////////////////////////////////////////////////////////////////////////////
+#include <cassert>
+
+#include "..\include\SeekIndex.h"
+
+// ---------------------------------------------------------------------------
+// Constructor / destructor
+// ---------------------------------------------------------------------------
+// Constructor
+SeekIndex::SeekIndex(std::size_t blockSize) : _blockSize(blockSize), _symbols(0), _bits(0), _offsets()
+{
+	assert(_blockSize > 0 && _blockSize <= max_block_size);
+}
+
+// Destructor
+SeekIndex::~SeekIndex()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Building the index
+// ---------------------------------------------------------------------------
+// Removes all blocks, keeping the block size
+void SeekIndex::clear()
+{
+	_symbols = 0;
+	_bits = 0;
+	_offsets.clear();
+}
+
+// Adds the start of a block, which must follow the previous block
+void SeekIndex::add_block(unsigned long long bitOffset)
+{
+	assert(_offsets.empty() || bitOffset >= _offsets.back());
+	_offsets.push_back(bitOffset);
+}
+
+// Adds the number of bytes and codeword bits encoded
+void SeekIndex::add_coded(unsigned long long symbols, unsigned long long bits)
+{
+	_symbols += symbols;
+	_bits += bits;
+}
+
+// ---------------------------------------------------------------------------
+// Access methods
+// ---------------------------------------------------------------------------
+std::size_t SeekIndex::block_size() const
+{
+	return _blockSize;
+}
+
+unsigned long long SeekIndex::symbols() const
+{
+	return _symbols;
+}
+
+unsigned long long SeekIndex::bits() const
+{
+	return _bits;
+}
+
+std::size_t SeekIndex::blocks() const
+{
+	return _offsets.size();
+}
+
+unsigned long long SeekIndex::block_offset(std::size_t block) const
+{
+	assert(block < _offsets.size());
+	return _offsets[block];
+}
+
+// ---------------------------------------------------------------------------
+// Storage
+// ---------------------------------------------------------------------------
+// Writes the block size, the number of bytes and the number of bits as 64 bit big-endian numbers,
+// followed by the offsets of the blocks
+void SeekIndex::save(ByteStream& stream) const
+{
+	std::vector<char> bytes;
+	bytes.reserve(header_size + _offsets.size() * 8);
+
+	auto put = [&bytes](unsigned long long value)
+	{
+		for (int shift = 56; shift >= 0; shift -= 8)
+			bytes.push_back(static_cast<char>(value >> shift));
+	};
+
+	put(_blockSize);
+	put(_symbols);
+	put(_bits);
+	for (auto i = _offsets.cbegin(); i != _offsets.cend(); i++)
+		put(*i);
+
+	stream.clear();
+	stream.append(bytes.data(), bytes.size());
+}
+
+// Reads an index written by save()
+bool SeekIndex::load(const ByteStream& stream)
+{
+	if (stream.size() < header_size || (stream.size() - header_size) % 8 != 0)
+		return false;
+
+	std::size_t position = 0;
+	auto get = [&stream, &position]() -> unsigned long long
+	{
+		unsigned long long value = 0;
+		for (int i = 0; i < 8; i++)
+			value = (value << 8) | static_cast<unsigned char>(stream[position++]);
+		return value;
+	};
+
+	const unsigned long long block_size = get();
+	const unsigned long long symbols = get();
+	const unsigned long long bits = get();
+	const std::size_t blocks = (stream.size() - header_size) / 8;
+
+	// There is a block for every started block_size bytes
+	if (block_size == 0 || block_size > max_block_size || blocks != (symbols + block_size - 1) / block_size)
+		return false;
+
+	std::vector<unsigned long long> offsets(blocks);
+	for (std::size_t i = 0; i < blocks; i++)
+	{
+		offsets[i] = get();
+		if (offsets[i] >= bits || (i > 0 && offsets[i] < offsets[i - 1]))
+			return false;
+	}
+
+	_blockSize = static_cast<std::size_t>(block_size);
+	_symbols = symbols;
+	_bits = bits;
+	_offsets.swap(offsets);
+
+	return true;
+}
+// ---------------------------------------------------------------------------
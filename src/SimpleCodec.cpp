@@ -0,0 +1,631 @@
+//////////////////////////////////////////////////////////////////////////////
+// Simple compression codec implementation
+//////////////////////////////////////////////////////////////////////////////
+#include <cassert>
+#include <cstdint>
+
+#include "..\include\SimpleCodec.h"
+
+// ---------------------------------------------------------------------------
+// Constructor / destructor
+// ---------------------------------------------------------------------------
+// Constructor
+SimpleCodec::SimpleCodec()
+	:	_bitsShort(0),
+		_bitsLong(0),
+		_tableBits(0),
+		_encodingTable{},
+		_decodingTable(),
+		_multiDecodingTable(),
+		_encodeKernel(nullptr),
+		_decodeKernel(nullptr),
+		_specialized(false),
+		_keyId(0)
+{
+}
+
+// Destructor
+SimpleCodec::~SimpleCodec()
+{
+}
+
+// ---------------------------------------------------------------------------
+// Private methods
+// ---------------------------------------------------------------------------
+// Retrieves data from the key stream
+bool SimpleCodec::ReadMapFromKeyStream(const ByteStream& keyStream, encoding_map& map, int& bits_short, int& bits_long)
+{
+	// Make sure that the header bytes are available
+	if (keyStream.size() < key_header_size)
+		return false;
+
+	// Get the header bytes (the counts are stored as 16 bit big-endian numbers, as there may be 256 unique bytes)
+	int map_size = (static_cast<unsigned char>(keyStream[0]) << 8) | static_cast<unsigned char>(keyStream[1]);
+	int short_words_count = (static_cast<unsigned char>(keyStream[2]) << 8) | static_cast<unsigned char>(keyStream[3]);
+	bits_short = static_cast<unsigned char>(keyStream[4]);
+	bits_long = static_cast<unsigned char>(keyStream[5]);
+
+	// Short codewords are read as a single byte, and long codewords extend them by at most a byte
+	if (bits_short < 1 || bits_short > 8 || (bits_long != 0 && (bits_long <= bits_short || bits_long > bits_short + 8)))
+		return false;
+
+	// Long codewords need a length
+	if (map_size > 256 || short_words_count > map_size || (bits_long == 0 && short_words_count < map_size))
+		return false;
+
+	// Make sure that enough data is available (each codeword follows its byte)
+	const std::size_t key_bits = 8 * key_header_size + static_cast<std::size_t>(short_words_count) * (8 + bits_short) + static_cast<std::size_t>(map_size - short_words_count) * (8 + bits_long);
+	if (keyStream.size() * 8 < key_bits)
+		return false;
+
+	// Get a "pointer" to the next bit to read from the stream
+	bitstream_index bit_ptr = 8 * static_cast<bitstream_index>(key_header_size);
+
+	// Get all of the short codewords
+	for (int i = 0; i < short_words_count; i++)
+	{
+		// Get the key byte
+		char key = keyStream.read(bit_ptr, 8);
+		bit_ptr += 8;
+
+		// Get the codeword
+		unsigned int codeword = static_cast<unsigned int>(keyStream.read(bit_ptr, bits_short)) & 0xFF;
+		bit_ptr += bits_short;
+
+		map[key] = codeword_pair(codeword, bits_short);
+	}
+
+	// Get all of the long codewords
+	for (int i = short_words_count; i < map_size; i++)
+	{
+		// Get the key byte
+		char key = keyStream.read(bit_ptr, 8);
+		bit_ptr += 8;
+
+		// Get the codeword
+		unsigned int codeword;
+		if (bits_long > 8)
+		{
+			unsigned int codeword_part1 = static_cast<unsigned int>(keyStream.read(bit_ptr, 8)) & 0xFF;
+			unsigned int codeword_part2 = static_cast<unsigned int>(keyStream.read(bit_ptr + 8, bits_long - 8)) & 0xFF;
+			codeword = (codeword_part1 << (bits_long - 8)) | codeword_part2;
+		}
+		else
+		{
+			codeword = static_cast<unsigned int>(keyStream.read(bit_ptr, bits_long)) & 0xFF;
+		}
+		bit_ptr += static_cast<bitstream_index>(bits_long);
+
+		map[key] = codeword_pair(codeword, bits_long);
+	}
+
+	return true;
+}
+
+// Populate the encoding table (bytes without a codeword keep a length of zero)
+void SimpleCodec::GetEncodingTable(const encoding_map& encodingMap)
+{
+	for (auto i = encodingMap.cbegin(); i != encodingMap.cend(); i++)
+	{
+		encoding_entry& entry = _encodingTable[static_cast<unsigned char>(i->first)];
+		entry.codeword = static_cast<unsigned short>(i->second.first);
+		entry.bits = static_cast<unsigned char>(i->second.second);
+	}
+}
+
+// Populate a decoding table, indexed by as many bits as the longest codeword.
+// Each entry holds the byte decoded from a codeword starting with the index bits,
+// such that escaped (long) codewords are resolved by the same lookup as short codewords.
+void SimpleCodec::GetDecodingTable(const encoding_map& encodingMap)
+{
+	const int bits_short = _bitsShort;
+	const int bits_long = _bitsLong;
+	const int table_bits = _tableBits;
+	const int short_shift = table_bits - bits_short;						// Number of index bits following a short codeword
+	const unsigned int extended_bitset_key = (1u << bits_short) - 1;		// Bitsequence used to indicate that further bits are needed for the codeword
+
+	// Codewords not present in the map are decoded as zero bytes
+	// Note: bits_long is zero if there are no extended codewords
+	_decodingTable.assign(static_cast<std::size_t>(1) << table_bits, decoding_entry{ 0, static_cast<unsigned char>(bits_short) });
+	if (bits_long != 0)
+		for (unsigned int i = extended_bitset_key << short_shift; i < (1u << table_bits); i++)
+			_decodingTable[i].bits = static_cast<unsigned char>(bits_long);
+
+	// Fill the decoding table
+	for (auto i = encodingMap.cbegin(); i != encodingMap.cend(); i++)
+	{
+		const unsigned int codeword = static_cast<unsigned int>(i->second.first);
+
+		if (i->second.second == bits_short && !(bits_long != 0 && codeword == extended_bitset_key))
+		{
+			// A short codeword is followed by any combination of remaining index bits
+			for (unsigned int j = codeword << short_shift; j < ((codeword + 1) << short_shift); j++)
+				_decodingTable[j].symbol = i->first;
+		}
+		else if (bits_long != 0 && i->second.second == bits_long && (codeword >> (bits_long - bits_short)) == extended_bitset_key)
+		{
+			_decodingTable[codeword].symbol = i->first;
+		}
+	}
+}
+
+// Populate a multi-symbol decoding table from a (single-symbol) decoding table.
+// Each entry decodes as many codewords as are complete within the index bits, such that
+// short codewords are decoded several at a time.
+void SimpleCodec::GetMultiDecodingTable()
+{
+	_multiDecodingTable.assign(1 << multi_decoding_bits, multi_decoding_entry{ { 0 }, 0, 0 });
+
+	for (unsigned int i = 0; i < _multiDecodingTable.size(); i++)
+	{
+		multi_decoding_entry& entry = _multiDecodingTable[i];
+
+		while (entry.count < multi_decoding_symbols)
+		{
+			// Index bits following the codewords decoded so far (padded with zeros)
+			const unsigned int remaining = (i << entry.bits) & ((1u << multi_decoding_bits) - 1);
+			const unsigned int index = (_tableBits <= multi_decoding_bits) ? (remaining >> (multi_decoding_bits - _tableBits)) : (remaining << (_tableBits - multi_decoding_bits));
+
+			// The codeword must be complete within the index bits,
+			// otherwise the padding may have been taken for part of it
+			const decoding_entry& codeword = _decodingTable[index];
+			if (entry.bits + codeword.bits > multi_decoding_bits)
+				break;
+
+			entry.symbols[entry.count++] = codeword.symbol;
+			entry.bits += codeword.bits;
+		}
+	}
+}
+
+// Reads 8 bytes from the data as a big-endian integer, such that the first bit in the stream is the most significant bit
+unsigned long long SimpleCodec::PeekBits(const char* data, std::size_t byte_index)
+{
+	unsigned long long bits = 0;
+	for (int i = 0; i < 8; i++)
+		bits = (bits << 8) | static_cast<unsigned char>(data[byte_index + i]);
+
+	return bits;
+}
+
+// Decodes upto a maximum number of bytes, starting at a bit of the input, and returns the number of bytes decoded.
+// The bit index ("pointer") is advanced past the decoded codewords.
+std::size_t SimpleCodec::DecodeBits(ByteView input, bitstream_index& bit_ptr, ByteSink& output, std::size_t maxSymbols) const
+{
+	return (this->*_decodeKernel)(input, bit_ptr, output, maxSymbols);
+}
+
+// Encodes a part of a message. The codeword length is a constant if FixedBits is set, such that
+// the compiler can fold it into the shifts, and no length is looked up.
+template <int FixedBits>
+bool SimpleCodec::EncodeKernel(ByteView input, ByteSink& output, encoding_state& state, bool final, SeekIndex* index) const
+{
+	// Reserve room for the longest possible encoding
+	char* const first = output.reserve(MaxEncodedSize(input.size));
+	if (first == nullptr)
+		return false;
+	char* out = first;
+
+	unsigned long long bits = state.bits;	// Pending bits, the first of them being the most significant of the lowest 'count' bits
+	int count = state.count;				// Number of pending bits
+	bool missing = false;					// Set if a byte has no codeword
+	const int carried = state.count;		// Bits of the previous part, which are written to the first output byte
+
+	std::size_t i = 0;
+	while (i < input.size)
+	{
+		// With an index, the bytes are encoded a block at a time, noting the bit offset at which each block starts
+		std::size_t end = input.size;
+		if (index != nullptr)
+		{
+			const std::size_t block_size = index->block_size();
+			const std::size_t position = static_cast<std::size_t>((index->symbols() + i) % block_size);
+			if (position == 0)
+				index->add_block(index->bits() + static_cast<unsigned long long>(out - first) * 8 + count - carried);
+			if (input.size - i > block_size - position)
+				end = i + (block_size - position);
+		}
+
+		for (; i < end; i++)
+		{
+			// Get the codeword for the current byte, and the number of bits in the codeword
+			const encoding_entry& entry = _encodingTable[static_cast<unsigned char>(input.data[i])];
+			const int codeword_bits = (FixedBits != 0) ? FixedBits : entry.bits;
+			missing |= (entry.bits == 0);
+
+			bits = (bits << codeword_bits) | entry.codeword;
+			count += codeword_bits;
+
+			// Write whole bytes 4 at a time (no codeword is longer than 16 bits, so the pending bits never exceed 48)
+			if (count >= 32)
+			{
+				count -= 32;
+				const unsigned long long word = bits >> count;
+				out[0] = static_cast<char>(word >> 24);
+				out[1] = static_cast<char>(word >> 16);
+				out[2] = static_cast<char>(word >> 8);
+				out[3] = static_cast<char>(word);
+				out += 4;
+			}
+		}
+	}
+
+	// Write the remaining whole bytes
+	for (; count >= 8; count -= 8)
+		*(out++) = static_cast<char>(bits >> (count - 8));
+
+	if (index != nullptr)
+		index->add_coded(input.size, static_cast<unsigned long long>(out - first) * 8 + count - carried);
+
+	// Pad the last byte, or keep its bits for the next part
+	if (final && count > 0)
+	{
+		*(out++) = static_cast<char>(bits << (8 - count));
+		count = 0;
+	}
+	state.bits = bits & ((1ULL << count) - 1);
+	state.count = count;
+
+	output.commit(out - first);
+
+	return !missing;
+}
+
+// Decodes from a bit of the input. The codeword length is a constant if FixedBits is set, such that
+// the codewords of a peek can be looked up with shifts the compiler folds.
+template <int FixedBits>
+std::size_t SimpleCodec::DecodeKernel(ByteView input, bitstream_index& bit_ptr, ByteSink& output, std::size_t maxSymbols) const
+{
+	std::size_t symbols = 0;	// Number of bytes decoded
+
+	const int bits_short = (FixedBits != 0) ? FixedBits : _bitsShort;
+	const int bits_long = (FixedBits != 0) ? 0 : _bitsLong;
+	const int table_bits = (bits_long > bits_short) ? bits_long : bits_short;
+	const int step_bits = (table_bits > multi_decoding_bits) ? table_bits : multi_decoding_bits;	// Most bits consumed by a lookup
+
+	const char* data = input.data;
+	const bitstream_index total_bytes = static_cast<bitstream_index>(input.size);
+	const bitstream_index total_bits = total_bytes * 8;
+	const bitstream_index end_bits = (maxSymbols == all_symbols) ? total_bits - 1 : total_bits;	// Bits that may be decoded
+
+	// While 8 bytes can be read from the current position, a batch of lookups can be done
+	// without checking for the end of the stream, as no lookup consumes more than step_bits
+	const bitstream_index fast_end = total_bits - 7 * 8;	// Bits from which 8 bytes can no longer be read
+
+	// Compiled for fixed length codewords, the codewords within the (at least 57) bits of a peek
+	// can be looked up independently of each other, as their lengths are known
+	if (FixedBits != 0)
+	{
+		const int fixed_bits = (FixedBits != 0) ? FixedBits : 8;
+		const int peek_symbols = 56 / fixed_bits;
+		const int peek_bits = peek_symbols * fixed_bits;
+
+		std::size_t remaining_symbols = maxSymbols;
+		if (remaining_symbols > output.room())
+			remaining_symbols = output.room();
+		bitstream_index batch = (fast_end - bit_ptr) / peek_bits;
+		if (batch > 0 && static_cast<unsigned long long>(batch) > remaining_symbols / peek_symbols)
+			batch = static_cast<bitstream_index>(remaining_symbols / peek_symbols);
+
+		if (batch > 0)
+		{
+			char* out = output.reserve(static_cast<std::size_t>(batch) * peek_symbols);
+			for (bitstream_index i = 0; i < batch; i++)
+			{
+				unsigned long long bits = PeekBits(data, static_cast<std::size_t>(bit_ptr >> 3)) << (bit_ptr & 7);
+				for (int j = 0; j < peek_symbols; j++)
+				{
+					out[j] = _decodingTable[static_cast<std::size_t>(bits >> (64 - fixed_bits))].symbol;
+					bits <<= fixed_bits;
+				}
+				out += peek_symbols;
+				bit_ptr += peek_bits;
+			}
+
+			output.commit(static_cast<std::size_t>(batch) * peek_symbols);
+			symbols += static_cast<std::size_t>(batch) * peek_symbols;
+		}
+	}
+
+	for (;;)
+	{
+		// Each lookup decodes at most multi_decoding_symbols bytes, which must fit in the output
+		std::size_t remaining_symbols = maxSymbols - symbols;
+		if (remaining_symbols > output.room())
+			remaining_symbols = output.room();
+		bitstream_index batch = (fast_end - bit_ptr) / step_bits;
+		if (batch > 0 && static_cast<unsigned long long>(batch) > remaining_symbols / multi_decoding_symbols)
+			batch = static_cast<bitstream_index>(remaining_symbols / multi_decoding_symbols);
+		if (batch > decoding_batch_lookups)
+			batch = decoding_batch_lookups;
+		if (batch <= 0)
+			break;
+
+		// Each lookup writes all symbol slots, but only keeps the decoded ones
+		char* const first = output.reserve(static_cast<std::size_t>(batch) * multi_decoding_symbols);
+		char* out = first;
+
+		for (bitstream_index i = 0; i < batch; i++)
+		{
+			// Look up the codewords starting at the current bit
+			const unsigned long long bits = PeekBits(data, static_cast<std::size_t>(bit_ptr >> 3)) << (bit_ptr & 7);
+			const multi_decoding_entry& entry = _multiDecodingTable[static_cast<std::size_t>(bits >> (64 - multi_decoding_bits))];
+
+			// Codewords no longer than the multi-symbol table index always decode at least one byte
+			if (table_bits <= multi_decoding_bits || entry.count > 0)
+			{
+				for (int j = 0; j < multi_decoding_symbols; j++)
+					out[j] = entry.symbols[j];
+				out += entry.count;
+				bit_ptr += entry.bits;
+			}
+			else
+			{
+				// The codeword is longer than the multi-symbol table index
+				const decoding_entry& single = _decodingTable[static_cast<std::size_t>(bits >> (64 - table_bits))];
+				*(out++) = single.symbol;
+				bit_ptr += single.bits;
+			}
+		}
+
+		output.commit(out - first);
+		symbols += out - first;
+	}
+
+	// Decode the remaining codewords, checking that each of them is within the stream
+	while (symbols < maxSymbols && output.room() > 0 && bit_ptr + bits_short <= end_bits)
+	{
+		// Bytes beyond the end of the stream are read as zero
+		unsigned long long bits = 0;
+		for (bitstream_index i = 0; i < 8; i++)
+		{
+			const bitstream_index byte_index = (bit_ptr >> 3) + i;
+			const unsigned long long byte = (byte_index < total_bytes) ? static_cast<unsigned char>(data[byte_index]) : 0;
+			bits = (bits << 8) | byte;
+		}
+
+		const decoding_entry entry = _decodingTable[static_cast<std::size_t>((bits << (bit_ptr & 7)) >> (64 - table_bits))];
+
+		// End of file reached within an extended codeword
+		if (bit_ptr + entry.bits > end_bits)
+			break;
+
+		*output.reserve(1) = entry.symbol;
+		output.commit(1);
+		++symbols;
+		bit_ptr += entry.bits;
+	}
+
+	return symbols;
+}
+
+// Builds the table of loops for all the supported codeword lengths
+template <std::size_t... Indices>
+const SimpleCodec::kernel_pair* SimpleCodec::KernelTable(std::index_sequence<Indices...>)
+{
+	static const kernel_pair table[] =
+	{
+		{ &SimpleCodec::EncodeKernel<kernel_min_bits + Indices>, &SimpleCodec::DecodeKernel<kernel_min_bits + Indices> }...
+	};
+
+	return table;
+}
+
+// Selects the loops compiled for the codeword lengths of the key, or the generic loops
+void SimpleCodec::SelectKernels(bool specialized)
+{
+	static const std::size_t kernel_count = kernel_max_bits - kernel_min_bits + 1;
+	static const kernel_pair* const kernels = KernelTable(std::make_index_sequence<kernel_count>());
+
+	_specialized = specialized && _bitsLong == 0 && _bitsShort >= kernel_min_bits && _bitsShort <= kernel_max_bits;
+	if (_specialized)
+	{
+		const std::size_t kernel = static_cast<std::size_t>(_bitsShort - kernel_min_bits);
+		_encodeKernel = kernels[kernel].encode;
+		_decodeKernel = kernels[kernel].decode;
+	}
+	else
+	{
+		_encodeKernel = &SimpleCodec::EncodeKernel<0>;
+		_decodeKernel = &SimpleCodec::DecodeKernel<0>;
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Factory method
+// ---------------------------------------------------------------------------
+// Parses a key stream and builds the encoding and decoding tables
+std::shared_ptr<const SimpleCodec> SimpleCodec::Compile(const ByteStream& keyStream, bool specialized)
+{
+	std::shared_ptr<SimpleCodec> codec(new SimpleCodec());
+
+	// Read the key data
+	encoding_map map;
+	if (!ReadMapFromKeyStream(keyStream, map, codec->_bitsShort, codec->_bitsLong))
+		return nullptr;
+
+	// The decoding table is indexed by as many bits as the longest codeword
+	codec->_tableBits = (codec->_bitsLong > codec->_bitsShort) ? codec->_bitsLong : codec->_bitsShort;
+
+	codec->GetEncodingTable(map);
+	codec->GetDecodingTable(map);
+	codec->GetMultiDecodingTable();
+	codec->SelectKernels(specialized);
+	codec->_keyId = KeyId(keyStream);
+
+	return codec;
+}
+
+// Hashes the bytes of the key stream (32 bit FNV-1a)
+unsigned int SimpleCodec::KeyId(const ByteStream& keyStream)
+{
+	std::uint32_t hash = 2166136261u;
+	for (auto i = keyStream.cbegin(); i != keyStream.cend(); i++)
+	{
+		hash ^= static_cast<unsigned char>(*i);
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+// ---------------------------------------------------------------------------
+// Encoding / decoding
+// ---------------------------------------------------------------------------
+// Appends the codewords of the input bytes to the output, padding the last byte with zero bits.
+// Returns false if any of the input bytes has no codeword in the key, or if the output has too little room.
+bool SimpleCodec::Encode(ByteView input, ByteSink& output) const
+{
+	encoding_state state{};
+	return Encode(input, output, state, true);
+}
+
+bool SimpleCodec::Encode(ByteView input, std::vector<char>& output) const
+{
+	VectorSink sink(output);
+	return Encode(input, sink);
+}
+
+// Encodes a message, replacing the blocks of the index with those of the message
+bool SimpleCodec::Encode(ByteView input, ByteSink& output, SeekIndex& index) const
+{
+	index.clear();
+
+	encoding_state state{};
+	return Encode(input, output, state, true, &index);
+}
+
+// Appends the codewords of a part of a message to the output. Bits that do not fill a whole byte are
+// kept in the state for the next part, unless this is the final part, in which case they are padded.
+// If an index is given, the blocks starting within the part are added to it.
+bool SimpleCodec::Encode(ByteView input, ByteSink& output, encoding_state& state, bool final, SeekIndex* index) const
+{
+	assert(state.count >= 0 && state.count < 8);
+
+	return (this->*_encodeKernel)(input, output, state, final, index);
+}
+
+// Returns the room an encoding of a number of bytes may need in the output,
+// which includes the bytes of a partially used 32 bit write and bits carried over from a previous part
+std::size_t SimpleCodec::MaxEncodedSize(std::size_t size) const
+{
+	return (size * static_cast<std::size_t>(_tableBits) + 7) / 8 + 4;
+}
+
+// Appends the bytes decoded from the input to the output, stopping after a maximum number of bytes
+// or when the output is full. Returns the number of bytes decoded.
+// NOTE: Without a maximum, padding cannot be told apart from codewords. Codewords are then only decoded
+//       if they end before the last bit of the stream, and zero bits padding the last byte may still
+//       be decoded as additional bytes.
+std::size_t SimpleCodec::Decode(ByteView input, ByteSink& output, std::size_t maxSymbols) const
+{
+	bitstream_index bit_ptr = 0;
+	return DecodeBits(input, bit_ptr, output, maxSymbols);
+}
+
+std::size_t SimpleCodec::Decode(ByteView input, std::vector<char>& output, std::size_t maxSymbols) const
+{
+	VectorSink sink(output);
+	return Decode(input, sink, maxSymbols);
+}
+
+// Appends the bytes of a range of the message to the output, starting to decode at the block of the index covering
+// the offset. Returns false if the range is not within the message, or if the input or the room of the output
+// ends before the whole range is decoded.
+bool SimpleCodec::DecodeRange(ByteView input, const SeekIndex& index, unsigned long long offset, std::size_t length, ByteSink& output) const
+{
+	if (offset > index.symbols() || length > index.symbols() - offset)
+		return false;
+
+	if (length == 0)
+		return true;
+
+	// The input must hold all the codewords in the index
+	if (index.bits() > static_cast<unsigned long long>(input.size) * 8)
+		return false;
+
+	const std::size_t block = static_cast<std::size_t>(offset / index.block_size());
+	const std::size_t skip = static_cast<std::size_t>(offset % index.block_size());
+	bitstream_index bit_ptr = static_cast<bitstream_index>(index.block_offset(block));
+
+	// Decode the bytes of the block preceding the range, and discard them
+	char skipped[4096];
+	for (std::size_t remaining = skip; remaining > 0; )
+	{
+		const std::size_t count = (remaining < sizeof(skipped)) ? remaining : sizeof(skipped);
+		SpanSink sink(skipped, count);
+		if (DecodeBits(input, bit_ptr, sink, count) != count)
+			return false;
+		remaining -= count;
+	}
+
+	return (DecodeBits(input, bit_ptr, output, length) == length);
+}
+
+// Encodes each of the messages into the arena, with each message starting at a byte boundary
+bool SimpleCodec::EncodeBatch(const std::vector<ByteView>& messages, std::vector<char>& arena, std::vector<std::size_t>& offsets) const
+{
+	arena.clear();
+	offsets.clear();
+	offsets.reserve(messages.size() + 1);
+
+	bool success = true;
+	for (auto i = messages.cbegin(); i != messages.cend(); i++)
+	{
+		offsets.push_back(arena.size());
+		success &= Encode(*i, arena);
+	}
+	offsets.push_back(arena.size());
+
+	return success;
+}
+
+// Decodes each of the messages into the arena, given the number of bytes encoded in each message
+bool SimpleCodec::DecodeBatch(const std::vector<ByteView>& messages, const std::vector<std::size_t>& sizes, std::vector<char>& arena, std::vector<std::size_t>& offsets) const
+{
+	assert(sizes.size() == messages.size());
+
+	arena.clear();
+	offsets.clear();
+	offsets.reserve(messages.size() + 1);
+
+	std::size_t total_size = 0;
+	for (auto i = sizes.cbegin(); i != sizes.cend(); i++)
+		total_size += *i;
+	arena.reserve(total_size);
+
+	bool success = true;
+	for (std::size_t i = 0; i < messages.size(); i++)
+	{
+		offsets.push_back(arena.size());
+		success &= (Decode(messages[i], arena, sizes[i]) == sizes[i]);
+	}
+	offsets.push_back(arena.size());
+
+	return success;
+}
+
+// ---------------------------------------------------------------------------
+// Key properties
+// ---------------------------------------------------------------------------
+int SimpleCodec::bits_short() const
+{
+	return _bitsShort;
+}
+
+int SimpleCodec::bits_long() const
+{
+	return _bitsLong;
+}
+
+// Returns true if the loops compiled for the codeword lengths of the key are used
+bool SimpleCodec::specialized() const
+{
+	return _specialized;
+}
+
+unsigned int SimpleCodec::key_id() const
+{
+	return _keyId;
+}
+// ---------------------------------------------------------------------------